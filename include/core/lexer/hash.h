@@ -0,0 +1,36 @@
+/**
+ * @file hash.h
+ * @author redskaber (redskaber@foxmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2025-04-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @details 64-bit string hash.
+ *  Keys up to 16 bytes are read with at most four overlapping loads and one
+ *  128-bit multiply-mix (wyhash style), keys up to 64 bytes consume 16 bytes
+ *  per step, longer keys run four independent 64-bit accumulators over
+ *  32-byte stripes (xxh3 style) which the AVX2 build processes in one
+ *  vector register. Every path is defined on little-endian byte order and
+ *  the AVX2 and scalar stripe loops produce identical accumulators, so for a
+ *  given seed the output is the same on every build and may be persisted
+ *  (on-disk caches, precomputed hashes in symbol_defs.h).
+ */
+
+#pragma once
+#ifndef __NORTH_HASH_H__
+#define __NORTH_HASH_H__
+
+#include "common.h"
+
+
+// 固定种子：改动会使所有已持久化的哈希失效（含symbol_defs.h中的预计算值）
+#define HASH64_SEED     0x6e6f7274682d6c78ULL       // "north-lx"
+
+
+uint64_t hash64(const void* data, size_t len, uint64_t seed);
+
+
+
+#endif // __NORTH_HASH_H__
@@ -0,0 +1,98 @@
+/**
+ * @file lexer.h
+ * @author redskaber (redskaber@foxmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2025-04-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @details Lexer: source buffer -> linked Token stream.
+ *  Tokens come from the token pool and are linked through Token.next,
+ *  so streams can be spliced and concatenated without copying.
+ */
+
+#pragma once
+#ifndef __NORTH_LEXER_H__
+#define __NORTH_LEXER_H__
+
+#include "common.h"
+#include "lexer/token.h"
+#include "lexer/source_map.h"
+
+
+// 并行词法分析的最小分块大小
+#define LEXER_PAR_MIN_CHUNK     (64 << 10)      // 64KB
+#define LEXER_PAR_MAX_THREADS   64
+// 词法分析在Token末尾之后最多向前查看的字节数（增量重分析的安全距离，指数探测另行计算）
+#define LEXER_LOOKAHEAD         4
+
+
+// 词法错误码（Tk_Error的error_code）
+typedef enum LexError {
+    LEX_ERR_UNKNOWN_CHAR = 1,       // 无法识别的字符
+    LEX_ERR_UNTERMINATED_STR,       // 字符串未闭合
+    LEX_ERR_UNTERMINATED_CHAR,      // 字符字面量未闭合
+    LEX_ERR_UNTERMINATED_COMMENT,   // 块注释未闭合
+    LEX_ERR_INVALID_RAW_STR,        // 原始字符串格式错误
+    LEX_ERR_INVALID_NUMBER,         // 数字字面量格式错误
+} LexError;
+
+// Token流：通过Token.next串联的单链表
+typedef struct TokenStream {
+    Token* head;
+    Token* tail;
+    size_t count;
+    uint32_t base;          // 源码在全局地址空间中的起点（Span.lo - base即缓冲区偏移）
+} TokenStream;
+
+// 文本编辑：旧文本[offset, offset+removed)被替换为inserted字节
+typedef struct TextEdit {
+    size_t offset;
+    size_t removed;
+    size_t inserted;
+} TextEdit;
+
+typedef struct Lexer {
+    const char* src;        // 源码缓冲区（整个文件）
+    size_t len;             // 缓冲区长度
+    size_t pos;             // 当前读取位置
+    size_t limit;           // 分块上限：Token起始位置不越过limit
+    uint32_t base;          // src[0]在全局地址空间中的位置（默认0）
+    uint32_t errors;        // 已产生的错误Token数量
+} Lexer;
+
+
+void lexer_init(Lexer* lexer, const char* src, size_t len);
+void lexer_init_range(Lexer* lexer, const char* src, size_t len, size_t start, size_t limit);
+
+// 返回下一个Token；到达limit时返回NULL（不产生Eof）
+Token* lexer_next(Lexer* lexer);
+// 词法分析整个缓冲区，结果以Tk_Eof结尾，返回错误Token数量。
+// 无转义的字符串与原始字符串借用src（零拷贝），src须在Token流释放前保持有效
+size_t lexer_tokenize(const char* src, size_t len, TokenStream* out);
+// 同上，Span位于file在source map中的地址区间
+size_t lexer_tokenize_file(const SourceFile* file, TokenStream* out);
+// 按换行切分为多个分块并行分析，接缝处校验推测并仅重做受影响分块
+size_t lexer_tokenize_parallel(const char* src, size_t len, size_t threads, TokenStream* out);
+// 增量重分析：stream为编辑前的Token流，src/len为编辑后的文本。
+// 从编辑点前最后一个安全Token重新分析，直到新Token与旧流重新对齐，
+// 其后的旧Token整体平移Span后接回；仍借用旧缓冲区的字符串改指向src。
+// 返回重新分析产生的Token数量。
+size_t lexer_relex(TokenStream* stream, const char* src, size_t len, const TextEdit* edit);
+
+
+// Token流操作
+void token_stream_init(TokenStream* stream);
+void token_stream_push(TokenStream* stream, Token* token);
+void token_stream_append(TokenStream* dst, TokenStream* src);   // O(1)拼接，src被清空
+void token_stream_free(TokenStream* stream);
+
+// 分隔符配对：lexer_tokenize / lexer_tokenize_parallel / lexer_relex产生的流中，
+// 每个已配对的Tk_OpenDelim与Tk_CloseDelim经data.delim.match互相指向对方
+void token_stream_match_delims(TokenStream* stream);     // 手工拼接Token流后重新配对
+// 跳过以open开头的整个分组，返回闭分隔符之后的Token；open未配对时返回NULL
+Token* token_skip_group(const Token* open);
+
+
+#endif  // __NORTH_LEXER_H__
@@ -0,0 +1,49 @@
+/**
+ * @file literal.h
+ * @author redskaber (redskaber@foxmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2025-04-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @details Lazy literal payloads.
+ *  Numbers: the lexer records only the raw slice (Literal.symbol), the
+ *  suffix and the kind; values are decoded on first access through
+ *  token_literal().
+ *  Strings without escapes and raw strings: as.str / as.raw_str point into
+ *  the source buffer (zero-copy) and Literal.symbol stays empty until the
+ *  first access interns the slice. The source buffer must therefore outlive
+ *  the token stream (lexer_relex rebases these slices onto the new buffer).
+ */
+
+#pragma once
+#ifndef __NORTH_LITERAL_H__
+#define __NORTH_LITERAL_H__
+
+#include "common.h"
+#include "lexer/token.h"
+
+
+// 数值字面量解码状态（Literal.state）
+typedef enum LitState {
+    LIT_STATE_PENDING = 0,      // 尚未解码（字符串：内容仍借用源码）
+    LIT_STATE_OK,               // 已解码
+    LIT_STATE_OVERFLOW,         // 超出后缀（或u64）范围，值按位截断
+    LIT_STATE_INVALID,          // 无法解码
+} LitState;
+
+// 字符串类字面量（含字节串、C字符串及其原始形式）
+#define LIT_IS_STRING(kind)     ((kind) >= LIT_STR && (kind) <= LIT_CSTR_RAW)
+
+
+// 整数：支持0x/0o/0b前缀与`_`分隔，十进制每次处理8位数字
+LitState lit_parse_int(const char* s, size_t n, uint64_t* out);
+// 浮点：精确快速路径（Clinger），其余回退strtod/strtof；f32按单精度舍入
+LitState lit_parse_float(const char* s, size_t n, bool f32, double* out);
+
+// 就地解码数值字面量/内部化借用的字符串（其余或已解码时直接返回），并发调用安全
+LitState literal_decode(Literal* lit);
+
+
+#endif  // __NORTH_LITERAL_H__
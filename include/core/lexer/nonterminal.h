@@ -48,11 +48,16 @@ typedef struct {
     struct ASTBlock* block;
 } NtPatIdent;
 
+// 紧凑Span：全局源码地址空间中的起点 + 长度（地址空间见source_map.h）
 typedef struct Span {
-    int end;
-    int start;
+    uint32_t lo;
+    uint32_t len;
 } Span;
 
+#define SPAN_HI(s)          ((s).lo + (s).len)
+// 单个整数键：按起点排序，相等即同一区间
+#define SPAN_KEY(s)         (((uint64_t)(s).lo << 32) | (s).len)
+
 // 通用非终结符结构
 // typedef struct ALIGN_AS_CACHELINE Nonterminal {
 //     _Atomic uint32_t refcount;  // 引用计数
@@ -0,0 +1,122 @@
+/**
+ * @file ntok.h
+ * @author redskaber (redskaber@foxmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2025-04-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @details Binary token-stream cache (.ntok).
+ *  A file's token stream is stored as flat arrays (kinds, compact spans,
+ *  payloads) plus a string table for identifier/literal/comment text.
+ *  The file is mmapped and read in place: NtokView only points into the
+ *  mapping, nothing is deserialized per token. The header carries a format
+ *  version and a content hash of the source, so a stale cache is rejected
+ *  and the driver falls back to lexing. When the cache cannot be written,
+ *  the driver keeps the same image in memory and views it the same way.
+ *
+ *  Layout (all offsets from the start of the file, 8-byte aligned):
+ *      NtokHeader
+ *      uint8_t      kinds[token_count]
+ *      NtokSpan     spans[token_count]
+ *      NtokPayload  payloads[token_count]
+ *      NtokString   strings[string_count]
+ *      char         string_data[string_bytes]   (each string NUL-terminated)
+ */
+
+#pragma once
+#ifndef __NORTH_NTOK_H__
+#define __NORTH_NTOK_H__
+
+#include "common.h"
+#include "lexer/lexer.h"
+
+
+#define NTOK_MAGIC          0x4B4F544EU     // "NTOK"（小端）
+#define NTOK_VERSION        1
+#define NTOK_NO_STRING      UINT32_MAX
+
+
+// 紧凑Span：起点 + 长度
+typedef struct NtokSpan {
+    uint32_t start;
+    uint32_t len;
+} NtokSpan;
+
+// 每个Token的负载，按kind解释：
+//  Ident/Lifetime  : text=名字，flags=is_raw
+//  Literal         : text=原文，aux=后缀，sub=LitKind，flags=num_hashes
+//  DocComment      : text=内容，sub=CommentKind，flags=attr_style
+//  Open/CloseDelim : sub=Delimiter
+//  Error           : text=错误信息，aux=错误码
+typedef struct NtokPayload {
+    uint32_t text;          // 字符串表索引（NTOK_NO_STRING表示无）
+    uint32_t aux;
+    uint8_t sub;
+    uint8_t flags;
+    uint16_t _reserved;
+} NtokPayload;
+
+typedef struct NtokString {
+    uint32_t offset;        // 相对string_data
+    uint32_t len;
+} NtokString;
+
+typedef struct NtokHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t kind_count;    // 写入时的TokenKind数量（枚举变化即失效）
+    uint64_t content_hash;  // 源码内容哈希
+    uint64_t source_len;
+    uint32_t token_count;
+    uint32_t string_count;
+    uint64_t string_bytes;
+    uint64_t kinds_offset;
+    uint64_t spans_offset;
+    uint64_t payloads_offset;
+    uint64_t strings_offset;
+    uint64_t string_data_offset;
+    uint64_t file_size;
+} NtokHeader;
+
+// 只读视图：所有指针指向mmap区域
+typedef struct NtokView {
+    const NtokHeader* header;
+    const uint8_t* kinds;
+    const NtokSpan* spans;
+    const NtokPayload* payloads;
+    const NtokString* strings;
+    const char* string_data;
+    size_t count;           // Token数量（含Eof）
+    void* map;
+    size_t map_size;
+    bool mapped;            // map来自mmap；否则为未能落盘的堆内存映像
+} NtokView;
+
+
+// 源码内容哈希（64位，每次处理8字节）
+uint64_t ntok_content_hash(const char* src, size_t len);
+
+// 将stream序列化到path（先写临时文件再rename），成功返回0
+int ntok_write(const char* path, const char* src, size_t len, const TokenStream* stream);
+// mmap并校验缓存：版本、枚举、源码长度与哈希均匹配，且各项索引与区间都在界内时返回0，
+// 否则返回-1且view无效
+int ntok_open(const char* path, const char* src, size_t len, NtokView* view);
+void ntok_close(NtokView* view);
+
+// 驱动入口：缓存有效时直接使用，否则词法分析并重写缓存。
+// 返回1命中缓存，0已分析并写入缓存，2已分析但缓存写入失败（view指向内存映像），-1分析失败
+int ntok_load_or_lex(const char* path, const char* src, size_t len, NtokView* view);
+
+// 原位访问
+static inline TokenKind ntok_kind(const NtokView* view, size_t i) {
+    return (TokenKind)view->kinds[i];
+}
+static inline const char* ntok_text(const NtokView* view, size_t i) {
+    uint32_t s = view->payloads[i].text;
+    return s == NTOK_NO_STRING ? NULL : view->string_data + view->strings[s].offset;
+}
+
+
+#endif  // __NORTH_NTOK_H__
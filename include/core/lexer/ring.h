@@ -0,0 +1,84 @@
+/**
+ * @file ring.h
+ * @author redskaber (redskaber@foxmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2025-04-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @details Lock-free SPSC token ring between a lexer thread and a parser.
+ *  The producer and consumer indices live on separate cache lines; each
+ *  side keeps a private copy of its own index plus a cached copy of the
+ *  other side's, and publishes its index in batches, so the shared lines
+ *  bounce once per batch instead of once per token.
+ *  TokenPipe runs the lexer on its own thread and gives the parser an
+ *  ordinary next_token / peek_token(k) interface.
+ */
+
+#pragma once
+#ifndef __NORTH_RING_H__
+#define __NORTH_RING_H__
+
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "common.h"
+#include "lexer/lexer.h"
+
+
+#define TOKEN_RING_BATCH        64          // 批量发布的Token数量
+#define TOKEN_RING_DEFAULT      4096        // 默认容量（词法线程最多领先的Token数）
+
+
+typedef struct TokenRing {
+    Token** slots;
+    size_t mask;                            // 容量-1（容量为2的幂）
+
+    // 生产者独占行
+    _Atomic(size_t) tail ALIGN_AS_CACHELINE;    // 已发布的写位置
+    size_t tail_local;                          // 未发布的写位置
+    size_t head_cache;                          // 消费者位置的本地缓存
+
+    // 消费者独占行
+    _Atomic(size_t) head ALIGN_AS_CACHELINE;    // 已发布的读位置
+    size_t head_local;
+    size_t tail_cache;
+
+    atomic_bool closed ALIGN_AS_CACHELINE;      // 生产者已结束
+} TokenRing;
+
+
+// capacity向上取整为2的幂（不小于2*TOKEN_RING_BATCH），成功返回0
+int token_ring_init(TokenRing* ring, size_t capacity);
+void token_ring_destroy(TokenRing* ring);   // 释放环内剩余Token
+
+// 生产者：满时等待；每TOKEN_RING_BATCH个或flush/close时发布
+void token_ring_push(TokenRing* ring, Token* token);
+void token_ring_flush(TokenRing* ring);
+void token_ring_close(TokenRing* ring);
+
+// 消费者：空时等待；生产者关闭且已取尽时返回NULL
+Token* token_ring_pop(TokenRing* ring);
+// 查看第k个（0为下一个）未取出的Token，k须小于容量；不足k+1个且已关闭时返回NULL
+Token* token_ring_peek(TokenRing* ring, size_t k);
+
+
+// 词法/语法流水线：词法分析在独立线程中运行，最多领先capacity个Token
+typedef struct TokenPipe {
+    TokenRing ring;
+    Lexer lexer;
+    pthread_t thread;
+    bool started;
+} TokenPipe;
+
+int token_pipe_start(TokenPipe* pipe, const char* src, size_t len, size_t capacity);
+// 按源码顺序取出Token（所有权转移给调用方），以Tk_Eof结束，之后返回NULL。
+// 分隔符在闭合前就已交给消费者，故不做配对（data.delim.match为NULL）
+Token* next_token(TokenPipe* pipe);
+Token* peek_token(TokenPipe* pipe, size_t k);
+// 等待词法线程结束并释放未取出的Token，返回词法错误数量
+size_t token_pipe_finish(TokenPipe* pipe);
+
+
+#endif  // __NORTH_RING_H__
@@ -0,0 +1,37 @@
+/**
+ * @file scan.h
+ * @author redskaber (redskaber@foxmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2025-04-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @details Vectorized byte scanning for the lexer.
+ *  Input is processed in 64-byte blocks turned into per-character bitmasks
+ *  (AVX-512BW, AVX2 or SSE2, chosen at compile time; scalar otherwise).
+ */
+
+#pragma once
+#ifndef __NORTH_SCAN_H__
+#define __NORTH_SCAN_H__
+
+#include "common.h"
+
+
+#define SCAN_BLOCK      64
+
+
+// 从p开始查找未被转义的`"`，返回其位置（未找到返回len）；
+// has_escape置为该位置之前是否出现过`\`
+size_t scan_quoted(const char* src, size_t len, size_t p, bool* has_escape);
+// 从p开始查找原始字符串结束符：`"`后紧跟hashes个`#`，返回`"`的位置（未找到返回len）
+size_t scan_raw_close(const char* src, size_t len, size_t p, size_t hashes);
+
+// 从p开始查找下一个换行符，返回其位置（未找到返回len）
+size_t scan_line_end(const char* src, size_t len, size_t p);
+// 块注释（支持嵌套）：p为开头`/*`之后的位置，返回末尾`*/`之后的位置；未闭合返回SIZE_MAX
+size_t scan_block_comment(const char* src, size_t len, size_t p);
+
+
+#endif  // __NORTH_SCAN_H__
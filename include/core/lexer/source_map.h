@@ -0,0 +1,65 @@
+/**
+ * @file source_map.h
+ * @author redskaber (redskaber@foxmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2025-04-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @details Global source address space.
+ *  Every registered file gets a contiguous range [base, base+len] of one
+ *  32-bit address space (ranges are separated by one byte so an end-of-file
+ *  position still belongs to its file). A Span is then just {lo, len} in
+ *  that space: it identifies the file without an extra field, and ordering
+ *  or comparing spans is plain integer arithmetic. The map resolves a
+ *  global position back to file / line / column by binary search.
+ */
+
+#pragma once
+#ifndef __NORTH_SOURCE_MAP_H__
+#define __NORTH_SOURCE_MAP_H__
+
+#include "common.h"
+
+
+#define SOURCE_MAP_MAX      UINT32_MAX      // 全局地址空间上限
+
+
+typedef struct SourceFile {
+    char* name;
+    const char* src;        // 借用，须在引用它的Span使用期间保持有效
+    uint32_t base;          // 在全局地址空间中的起点
+    uint32_t len;
+    uint32_t* lines;        // 各行起点（相对文件）
+    uint32_t line_count;
+} SourceFile;
+
+typedef struct SourceMap {
+    SourceFile** files;     // 按base递增
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t next_base;
+} SourceMap;
+
+// 行、列均从1开始；列按字节计
+typedef struct SourceLoc {
+    const SourceFile* file;
+    uint32_t line;
+    uint32_t column;
+} SourceLoc;
+
+
+void source_map_init(SourceMap* map);
+void source_map_destroy(SourceMap* map);
+
+// 注册文件并分配地址区间；地址空间耗尽或内存不足时返回NULL。
+// 注册应在分析开始前完成，与查询不可并发
+const SourceFile* source_map_add(SourceMap* map, const char* name, const char* src, size_t len);
+// 全局位置所在文件，不在任何文件内时返回NULL
+const SourceFile* source_map_file(const SourceMap* map, uint32_t pos);
+// 全局位置 -> 文件/行/列，成功返回true
+bool source_map_lookup(const SourceMap* map, uint32_t pos, SourceLoc* loc);
+
+
+#endif  // __NORTH_SOURCE_MAP_H__
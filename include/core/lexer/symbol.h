@@ -6,24 +6,118 @@
 #include "common.h"
 
 // 符号表条目结构
+//  符号的生命周期即符号表的生命周期（init/load到cleanup），字符串与条目在cleanup时整体回收，
+//  不按符号计数：内部化路径上没有对共享内存的原子写
+//  短字符串（不超过SYMBOL_INLINE_MAX字节）连同'\0'与零填充直接存放在条目内，比较时与同样
+//  零填充的查找键做一次定长比较，不解引用指针；长字符串存放在字符串区，条目保留前4字节用于快速排除
+#define SYMBOL_INLINE_SIZE  20
+#define SYMBOL_INLINE_MAX   (SYMBOL_INLINE_SIZE - 1)
+
 typedef struct SymbolEntry {
-    const char* str;       // 字符串指针
-    size_t len;            // 字符串长度
-    uint32_t hash;         // 预计算哈希值
-    _Atomic uint32_t refcount; // 引用计数
+    uint64_t hash;         // hash64(str, len, HASH64_SEED)
+    uint32_t len;          // 字符串长度
+    union {
+        char str[SYMBOL_INLINE_SIZE];       // len <= SYMBOL_INLINE_MAX
+        struct __attribute__((packed)) {
+            char prefix[4];
+            const char* ptr;                // 指向字符串区，符号表销毁前有效
+        } ext;                              // len > SYMBOL_INLINE_MAX
+    } data;
 } SymbolEntry;
 
+// 字符串区：分块只追加，字符串连续存放、不移动，随符号表整体释放
+#define SYMTAB_ARENA_CHUNK  (64 << 10)
+
+typedef struct SymbolArenaChunk {
+    struct SymbolArenaChunk* next;
+    size_t size;           // data字节数
+    char data[];
+} SymbolArenaChunk;
+
+// 哈希索引：开放寻址，SwissTable式16字节控制组
+//  ctrl[i]为空槽（SYMTAB_CTRL_EMPTY）或条目哈希的低7位，slots[i]为条目ID；
+//  一次SIMD比较筛出一组16个槽中的候选，再用条目中保存的完整哈希与内容确认；
+//  哈希位划分：低7位为控制字节，其上SYMTAB_SHARD_BITS位选择分片，高32位选择起始组
+#define SYMTAB_GROUP        16
+#define SYMTAB_CTRL_EMPTY   0x80
+
+// 分片：按哈希位选择分片，各分片独立加锁，不同分片的内部化互不阻塞
+#define SYMTAB_SHARD_BITS   6
+#define SYMTAB_SHARDS       (1U << SYMTAB_SHARD_BITS)
+
+// 条目分段存储：第k段容量为(SYMTAB_SEG0 << k)，只追加不移动，
+// ID稳定且读者无需加锁（symbol_str不会看到被realloc的数组）
+#define SYMTAB_SEG0_BITS    10
+#define SYMTAB_SEG0         (1U << SYMTAB_SEG0_BITS)
+#define SYMTAB_SEGMENTS     22              // 共约2^32个条目
+
+// 分片索引：查找已有符号不加锁；写者持分片锁插入，先写条目与slots再以release写控制字节，
+//  扩容时发布新索引，旧索引挂在retired链上直到cleanup（总量不超过当前索引大小），
+//  因此读者手中的旧索引始终可读，只是可能看不到之后插入的符号
+typedef struct SymbolIndex {
+    uint8_t* ctrl;         // 控制字节（buckets个，按组对齐）
+    uint32_t* slots;       // 条目ID
+    size_t buckets;        // 槽数（2的幂，至少一组）
+    size_t used;           // 已占用槽数（负载上限7/8）
+    struct SymbolIndex* retired;    // 被本索引替换的旧索引
+} SymbolIndex;
+
+typedef struct __attribute__((aligned(64))) SymbolShard {
+    pthread_mutex_t lock;       // 仅插入与扩容时持有
+    _Atomic(SymbolIndex*) index;
+    SymbolArenaChunk* arena;    // 本分片的字符串区（表头为当前块）
+    size_t arena_used;          // 当前块已用字节
+} SymbolShard;
+
+// 线程本地内部化缓存：直接映射，按(哈希低32位, len)定位，命中时不执行原子操作、不改写共享内存
+#define SYMBOL_CACHE_BITS   12
+#define SYMBOL_CACHE_SIZE   (1U << SYMBOL_CACHE_BITS)
+
+// 批量内部化每块的输入数
+#define SYMBOL_BATCH_CHUNK  64
+
+typedef struct SymbolCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+} SymbolCacheStats;
+
+// 快照基础层：symbol_table_save写出的文件只读映射为ID [0, count)的符号，
+//  新符号在其上从count起继续编号，因此加载同一快照的各次运行ID一致
+typedef struct SymbolSnapshotEntry {
+    uint64_t hash;
+    uint32_t str;          // 在字符串区中的偏移（以'\0'结尾）
+    uint32_t len;
+} SymbolSnapshotEntry;
+
+typedef struct SymbolSnapshot {
+    void* map;             // 文件映射（NULL表示没有基础层）
+    size_t map_size;
+    const SymbolSnapshotEntry* entries;
+    const char* strings;
+    const uint8_t* ctrl;   // 只读索引，布局与分片索引相同，查找无需加锁
+    const uint32_t* slots;
+    size_t buckets;
+    uint32_t count;
+} SymbolSnapshot;
+
+typedef struct SymbolTableStats {
+    size_t symbols;         // 已分配的ID数（含预定义与基础层）
+    size_t base_symbols;    // 快照基础层中的符号数
+    size_t arena_chunks;    // 字符串区块数（即字符串的malloc次数）
+    size_t arena_bytes;     // 字符串区已用字节
+} SymbolTableStats;
+
 // 符号表结构
 typedef struct SymbolTable {
-    SymbolEntry* entries;  // 条目数组
-    size_t capacity;       // 总容量
-    size_t size;           // 当前大小
-    pthread_mutex_t lock;  // 线程安全锁
+    _Atomic(SymbolEntry*) segments[SYMTAB_SEGMENTS];   // 按需分配，发布后不再改变
+    _Atomic uint32_t size;                              // 已分配的ID数
+    SymbolSnapshot base;                                // 只读基础层，加载后不再改变
+    SymbolShard shards[SYMTAB_SHARDS];
 } SymbolTable;
 
 // 预定义符号ID
 typedef enum PredefinedSymbols {
-    #define SYM(label, str) SYM_##label,
+    #define SYM(label, str, hash) SYM_##label,
     // #define SYMBOL_LIST
     #include "symbol_defs.h"   
     SYMBOL_LIST
@@ -45,10 +139,22 @@ typedef struct Symbol {
 
 // 符号表API
 void symbol_table_init(void);
+// 整体释放条目、索引与字符串区，之后可重新init；须在不再使用任何Symbol且无并发内部化时调用
+void symbol_table_cleanup(void);
+void symbol_table_stats(SymbolTableStats* stats);
+// 快照：save写出当前全部符号（须无并发内部化），先写临时文件再改名；
+//  load映射快照作为基础层并完成初始化，须在符号表初始化之前调用；成功返回0，失败返回-1且不初始化
+int symbol_table_save(const char* path);
+int symbol_table_load(const char* path);
+// 长度超过UINT32_MAX的字符串不内部化，返回空符号
 Symbol symbol_intern(const char* str, size_t len);
+// 批量内部化：out[i]与symbol_intern(strs[i], lens[i])相同；每SYMBOL_BATCH_CHUNK个输入
+//  先统一哈希并预取索引，再查找，缺失者每个分片只加锁一次
+void symbol_intern_batch(const char** strs, const size_t* lens, size_t n, Symbol* out);
 const char* symbol_str(Symbol sym);
-void symbol_ref(Symbol sym);
-void symbol_unref(Symbol sym);
+// 当前线程的缓存命中统计
+void symbol_cache_stats(SymbolCacheStats* stats);
+void symbol_cache_reset_stats(void);
 
 // 预定义符号访问宏
 #define MACRO_SYM_EMPTY         (Symbol){SYM_EMPTY, SYM_FLAG_PREDEFINED}
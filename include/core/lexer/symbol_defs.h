@@ -1,8 +1,9 @@
+// SYM(标识, 字符串, hash64(字符串, 长度, HASH64_SEED))
+//  哈希在此预先算好，符号表初始化时不再逐个计算；改动HASH64_SEED或哈希算法时须同步更新（test_symbol会校验）
 #define SYMBOL_LIST     \
-    SYM(EMPTY,          "")     \
-    SYM(ROOT,           "root") \
-    SYM(UNDERSCORE,     "_")    \
-    SYM(DOLLAR_CRATE,   "$crate") \
-    SYM(AS,             "as")   \
-    SYM(BREAK,          "break") 
-
+    SYM(EMPTY,          "",         0xc2b31dd88c613ccfULL) \
+    SYM(ROOT,           "root",     0xf9f9f29c85ef4b00ULL) \
+    SYM(UNDERSCORE,     "_",        0xd56edcf0a01cc670ULL) \
+    SYM(DOLLAR_CRATE,   "$crate",   0xb4ec43c0540bb762ULL) \
+    SYM(AS,             "as",       0xb8bcca47a6d8a645ULL) \
+    SYM(BREAK,          "break",    0x26a69825138972cdULL)
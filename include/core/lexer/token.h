@@ -67,6 +67,7 @@ typedef struct Literal {
     LitKind kind;           // 字面量类型
     Symbol symbol;          // 符号表索引
     Symbol suffix;          // 类型后缀（例如 u8/f32）
+    _Atomic(uint8_t) state; // 数值解码状态（LitState），首次访问时由token_literal解码
     union {
         bool bool_val;      // 布尔值
         char char_val;      // 字符值
@@ -84,14 +85,17 @@ typedef struct Literal {
         } raw_str;
         struct {            // 错误字面量
             uint32_t error_code;
-            char* message;
+            Symbol message;  // 错误信息（已内部化）
         } error;
     } as;
 } Literal;
+
+// 字面量侧表索引（Token只保存32位索引，负载存放于侧表）
+typedef uint32_t LitId;
+#define LIT_ID_INVALID      UINT32_MAX
 typedef struct Ident {
     Symbol symbol;          // 符号表索引
-    bool is_raw;            // 是否原始标识符
-    Span span;              // 源码位置
+    bool is_raw;            // 是否原始标识符（位置即所在Token的span）
 } Ident;
 typedef enum CommentKind {
     COMMENT_LINE,           // //
@@ -165,13 +169,19 @@ typedef struct DocComment {
     Symbol symbol;
 } DocComment;
 typedef union TokenData {
-    struct { Delimiter delim; } delim;          // 分隔符
-    Literal literal;                            // 字面量
+    struct {                                    // 分隔符
+        Delimiter delim;
+        struct Token* match;                    // 配对的另一侧分隔符，未配对为NULL
+    } delim;
+    LitId literal;                              // 字面量（侧表索引）
     Ident ident;                                // 标识符
     DocComment doc_comment;                     // 文档注释
 } TokenData;
 typedef struct ALIGN_AS_CACHELINE Token {
-    struct Token* next_free;    // 仅用于空闲链表   8 bytes
+    union {
+        struct Token* next_free;    // 空闲链表         8 bytes
+        struct Token* next;         // Token流链表（存活期间复用同一字段）
+    };
     TokenKind type;
     Span span;                  // 源码位置
     TokenData data;             // 具体数据
@@ -215,7 +225,7 @@ typedef _Atomic TaggerPointer atomic_tp;
 #define TOKEN_POOL_BLOCK    1024                // 1024个Token
 typedef struct TokenBlock {
     Token* block ALIGN_AS_CACHELINE;            // Token指针
-    size_t used;                                // 已使用的Token数量
+    atomic_size_t used;                         // 已使用的Token数量
     struct TokenBlock* next;                    // 下一个TokenBlock
     uint8_t _pad[CACHE_LINE_SIZE - sizeof(Token*) - sizeof(size_t) - sizeof(void*)];
 } TokenBlock;
@@ -223,9 +233,26 @@ typedef _Atomic(TokenBlock*) atomic_tbp;
 
 
 
+typedef struct TokenPoolStats {
+    size_t blocks;                              // 常驻TokenBlock数量
+    size_t resident;                            // 常驻Token容量
+    size_t resident_bytes;                      // 常驻字节数
+    size_t in_use;                              // 使用中的Token数量
+    size_t peak_resident;                       // 常驻容量峰值
+    size_t limit;                               // 常驻上限（0表示不限制）
+} TokenPoolStats;
+
+
+
 void token_pool_init(size_t capacity);
 void token_pool_cleanup(void);
 
+// 内存修剪与上限
+// token_pool_trim 需在无并发分配/释放时调用，释放完全空闲的块直至常驻量不超过keep_tokens
+size_t token_pool_trim(size_t keep_tokens);
+void token_pool_set_limit(size_t max_tokens);   // 超出上限时token_alloc返回NULL
+void token_pool_stats(TokenPoolStats* stats);
+
 Token* token_alloc(TokenKind type, Span span);
 void token_free(Token* token);
 
@@ -238,6 +265,11 @@ Token* create_doc_comment(CommentKind kind, int attr_style, Symbol symbol, Span
 Token* create_lifetime(Symbol symbol, bool is_raw, Span span);
 Token* create_error_token(uint32_t error_code, const char* message, Span span);
 Token* create_eof(Span span);
+
+// 字面量侧表：分段追加、地址稳定，随token_pool_cleanup整体释放
+LitId literal_table_push(Literal lit);
+const Literal* literal_table_get(LitId id);
+const Literal* token_literal(const Token* token);     // 数值字面量在首次访问时解码
 // Token* create_interpolated(Nonterminal nt, Span span);
 
 
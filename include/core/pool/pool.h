@@ -18,8 +18,10 @@
 #include <assert.h>
 #include <stdint.h>
 #include <errno.h>
+#include <pthread.h>
 #include <stdatomic.h>
 #include <stdalign.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -76,37 +78,120 @@ typedef _Atomic(TaggedPointer) atomic_tp_t;
         {chunk, chunk, chunk,...}
         chunk：
             {node, node, node, ...}
+
+    首个chunk与Pool同块分配（memory），耗尽时按当前容量翻倍追加新chunk
+    （单块上限POOL_CHUNK_MAX_NODES），新chunk整链压入head，地址记入chunks链表，
+    pool_destroy时统一释放。
 */
 
+#define POOL_CHUNK_MAX_NODES    (1u << 16)      // 单次扩容最多追加的节点数
+
 typedef struct ALIGNED_CACHE_LINE Node {
     atomic_tp_t next ALIGNED_16;    // 原子指针+版本号
     uint8_t data[];                 // 用户数据区
 } Node;
 
+// 追加chunk的头部（独占一个缓存行，节点紧随其后）
+typedef struct ALIGNED_CACHE_LINE PoolChunk {
+    struct PoolChunk* next;         // 前一个追加的chunk
+    size_t count;                   // 本chunk节点数
+} PoolChunk;
+
+
+/**
+    线程缓存（Bonwick弹匣）：
+        每个线程对每个Pool持有一个PoolCache（loaded + previous两个弹匣），
+        单个与批量分配/释放都先走弹匣，只读写线程私有内存；
+        弹匣空/满时才与Pool的仓库（depot）交换满/空弹匣，仓库也为空时
+        才批量访问无锁链表。
+*/
+
+#define POOL_MAG_ROUNDS         64              // 每个弹匣容纳的对象数
+
+typedef struct PoolMagazine {
+    struct PoolMagazine* next;      // 仓库链表
+    size_t count;
+    void* rounds[POOL_MAG_ROUNDS];
+} PoolMagazine;
+
+struct Pool;
+
+// 弹匣所有权握手：所属线程操作期间置BUSY；回收线程在非对称屏障模式下置reclaim
+// 请求并确认state为IDLE，否则以CAS将state由IDLE置为RECLAIM
+#define POOL_CACHE_IDLE         0u
+#define POOL_CACHE_BUSY         1u
+#define POOL_CACHE_RECLAIM      2u
+
+// 由所属线程分配和释放；计数器仅所属线程写入，其他线程只读汇总
+typedef struct ALIGNED_CACHE_LINE PoolCache {
+    PoolMagazine* loaded;
+    PoolMagazine* previous;
+    atomic_uintptr_t alloc_cnt;     // 经弹匣完成的分配次数
+    atomic_uintptr_t free_cnt;      // 经弹匣完成的释放次数
+    atomic_uintptr_t cas_success;   // 本线程在无锁链表上成功的CAS次数
+    atomic_uintptr_t cas_fail;      // 本线程在无锁链表上失败的CAS次数
+    _Atomic(struct Pool*) pool;     // 所属Pool，Pool销毁后置NULL
+    struct PoolCache* next;         // Pool已注册缓存链表（depot.lock保护）
+    struct PoolCache* thread_next;  // 所属线程的缓存链表
+    atomic_uint state;              // POOL_CACHE_IDLE/BUSY/RECLAIM
+    atomic_uint reclaim;            // 回收请求（非对称屏障模式）
+    uint32_t idle_scans;            // 回收线程：连续无活动的扫描次数
+    uintptr_t seen_ops;             // 回收线程：上次扫描时的分配+释放次数
+} PoolCache;
+
+
+/**
+    回收线程（每个Pool至多一个）：
+        每period_us扫描一次已注册的线程缓存，分配+释放计数连续idle_periods次
+        不变的线程视为空闲，其弹匣中多于cache_low的对象归还无锁链表；
+        仓库满弹匣超过depot_high时归还至只剩depot_low个。
+*/
+typedef struct PoolReaperConfig {
+    uint32_t period_us;             // 扫描周期（微秒）
+    uint32_t idle_periods;          // 判定空闲所需的连续无活动周期数
+    size_t cache_low;               // 空闲线程缓存保留的对象数
+    size_t depot_high;              // 仓库满弹匣高水位
+    size_t depot_low;               // 仓库满弹匣低水位
+} PoolReaperConfig;
+
+#define POOL_REAPER_DEFAULT ((PoolReaperConfig){ \
+    .period_us = 1000, .idle_periods = 10, .cache_low = 0, .depot_high = 16, .depot_low = 8 })
+
 typedef struct ALIGNED_CACHE_LINE Pool {
-    void* memory;              // 预分配内存块
+    void* memory;              // 预分配内存块（首个chunk）
     atomic_tp_t head;          // 无锁队列头（独立缓存行）
     atomic_tp_t free_list;     // 缓存释放对象的链表
     size_t node_size;          // 对齐后的对象大小+头信息
-    size_t capacity;           // 池容量
+    atomic_size_t capacity;    // 池容量（随扩容增长）
+    PoolChunk* chunks;         // 追加的chunk链表（grow_lock保护）
+    atomic_size_t chunk_count; // chunk总数（含首个），grow_lock下写、无锁读
+    pthread_mutex_t grow_lock; // 扩容慢路径锁，快路径不获取
+    struct {
+        pthread_mutex_t lock;
+        PoolMagazine* full;    // 非空弹匣
+        PoolMagazine* empty;   // 空弹匣
+        size_t full_count;     // 非空弹匣数量
+        PoolCache* caches;     // 已注册的线程缓存
+    } depot ALIGNED_CACHE_LINE;
+    struct {
+        pthread_mutex_t lock;
+        pthread_cond_t cond;   // 停止通知
+        pthread_t tid;
+        bool running;
+        PoolReaperConfig config;
+        atomic_uintptr_t reclaimed;    // 累计归还无锁链表的对象数
+    } reaper;
     atomic_uintptr_t alloc_cnt;   // 分配计数器（调试用）
     atomic_uintptr_t free_cnt;    // 释放计数器（调试用）
     atomic_uintptr_t contention_counter;   // 冲突计数器（调试用）
     struct {
-        atomic_uintptr_t cas_success;       // cas成功计数器（调试用）
-        atomic_uintptr_t cas_fail;          // cas失败计数器（调试用）
+        atomic_uintptr_t cas_success;       // cas成功计数器（调试用，另计各线程缓存中的计数）
+        atomic_uintptr_t cas_fail;          // cas失败计数器（调试用，另计各线程缓存中的计数）
         atomic_uintptr_t cache_hit;         // 命中计数器（调试用）
+        atomic_uint level;                  // 竞争等级：决定退避起点与是否分流到线程缓存
     } stats ALIGNED_CACHE_LINE;
 } Pool;
 
-// cas
-#define UPDATE_CAS_STATS(pool, success) \
-    atomic_fetch_add_explicit(          \
-    (success) ? &(pool)->stats.cas_success : &(pool)->stats.cas_fail \
-    , 1, memory_order_relaxed           \
-    )
-
-
 // 内存对齐计算宏
 #define ALIGN_UP(size, align) (((size) + (align)-1) & ~((align)-1))
 #define NODE_DATA_SIZE(obj_size) ALIGN_UP(obj_size, 16)
@@ -117,6 +202,12 @@ typedef struct ALIGNED_CACHE_LINE Pool {
 static_assert(sizeof(Node) % CACHE_LINE_SIZE == 0,
     "Node structure requires cache line alignment");
 
+static_assert(sizeof(PoolChunk) == CACHE_LINE_SIZE,
+    "Chunk header must occupy exactly one cache line");
+
+static_assert(offsetof(Pool, depot) % CACHE_LINE_SIZE == 0,
+    "Depot must not share a cache line with the free lists");
+
 static_assert(offsetof(Pool, stats) % CACHE_LINE_SIZE == 0,
     "Statistics must be cache line aligned");
 
@@ -131,6 +222,7 @@ void pool_flush_cache(Pool* pool);
 void pool_destroy(Pool** pool_ptr);
 
 void pool_start_reaper(Pool* pool);
+int pool_start_reaper_config(Pool* pool, const PoolReaperConfig* config);
 void pool_stop_reaper(Pool* pool);
 
 
@@ -10,6 +10,11 @@ extern "C" {
 size_t get_alloc_cnt(Pool* pool);
 size_t get_free_cnt(Pool* pool);
 size_t get_contention_counter(Pool* pool);
+size_t get_capacity(Pool* pool);
+size_t get_chunk_count(Pool* pool);
+size_t get_reclaimed_cnt(Pool* pool);
+size_t get_cas_success(Pool* pool);
+size_t get_cas_fail(Pool* pool);
 
 
 #endif  // TEST_NORTH_POOL_H
@@ -11,6 +11,8 @@ extern "C" {
 TokenBlock* test_get_pool_head(void);
 size_t test_get_total_allocated(void);
 TaggerPointer test_get_free_list(void);
+size_t test_get_literal_count(void);
+void test_set_literal_count(size_t count);
 
 
 #endif  // TEST_TOKEN_POOL_H
@@ -0,0 +1,9 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern void entry_symbol(void**state);
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
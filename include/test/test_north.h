@@ -7,6 +7,9 @@ extern "C" {
 #include "sub/sub_ib.h"
 #include "sub/sub_token.h"
 #include "sub/sub_pool.h"
+#include "sub/sub_lexer.h"
+#include "sub/sub_ntok.h"
+#include "sub/sub_symbol.h"
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,168 @@
+#include <string.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "lexer/hash.h"
+
+
+#define HASH_STRIPE         32                  // 长键每步字节数（4条64位通道）
+#define HASH_SCRAMBLE       32                  // 每32个条带（1KB）扰动一次累加器
+
+static const uint64_t hash_secret[4] = {
+    0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL,
+    0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL,
+};
+
+// 长键通道密钥与扰动密钥
+static const uint64_t hash_lane_key[4] = {
+    0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL,
+    0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+};
+static const uint64_t hash_scramble_key[4] = {
+    0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL,
+    0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL,
+};
+#define HASH_PRIME32        0x9E3779B1U
+
+
+// 按小端读取，保证各平台结果一致
+static inline uint64_t hash_read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static inline uint64_t hash_read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+// 1~3字节：首、中、尾各取一字节
+static inline uint64_t hash_read_small(const uint8_t* p, size_t len) {
+    return ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+}
+
+// 64x64→128位乘法，就地返回低/高64位
+static inline void hash_mum(uint64_t* a, uint64_t* b) {
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+}
+
+static inline uint64_t hash_mix(uint64_t a, uint64_t b) {
+    hash_mum(&a, &b);
+    return a ^ b;
+}
+
+
+// ============================================================================
+// 长键条带循环
+//  acc[i^1] += d[i]; acc[i] += lo32(d[i]^key[i]) * hi32(d[i]^key[i])
+//  标量与AVX2实现逐位一致
+// ============================================================================
+#if defined(__AVX2__)
+static void hash_stripes(uint64_t acc[4], const uint8_t* p, size_t stripes) {
+    const __m256i key = _mm256_loadu_si256((const __m256i*)hash_lane_key);
+    const __m256i scramble = _mm256_loadu_si256((const __m256i*)hash_scramble_key);
+    const __m256i prime = _mm256_set1_epi32((int)HASH_PRIME32);
+    __m256i vacc = _mm256_loadu_si256((const __m256i*)acc);
+    for (size_t s = 0; s < stripes; ++s, p += HASH_STRIPE) {
+        __m256i d = _mm256_loadu_si256((const __m256i*)p);
+        __m256i dk = _mm256_xor_si256(d, key);
+        __m256i product = _mm256_mul_epu32(dk, _mm256_srli_epi64(dk, 32));
+        __m256i swapped = _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+        vacc = _mm256_add_epi64(vacc, _mm256_add_epi64(swapped, product));
+        if ((s + 1) % HASH_SCRAMBLE == 0) {
+            vacc = _mm256_xor_si256(vacc, _mm256_srli_epi64(vacc, 47));
+            vacc = _mm256_xor_si256(vacc, scramble);
+            // 64位乘32位常量：lo*c + (hi*c << 32)
+            __m256i lo = _mm256_mul_epu32(vacc, prime);
+            __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(vacc, 32), prime);
+            vacc = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+        }
+    }
+    _mm256_storeu_si256((__m256i*)acc, vacc);
+}
+#else
+static void hash_stripes(uint64_t acc[4], const uint8_t* p, size_t stripes) {
+    for (size_t s = 0; s < stripes; ++s, p += HASH_STRIPE) {
+        for (int i = 0; i < 4; ++i) {
+            uint64_t d = hash_read64(p + 8 * i);
+            uint64_t dk = d ^ hash_lane_key[i];
+            acc[i ^ 1] += d;
+            acc[i] += (dk & 0xFFFFFFFFU) * (dk >> 32);
+        }
+        if ((s + 1) % HASH_SCRAMBLE == 0) {
+            for (int i = 0; i < 4; ++i) {
+                acc[i] ^= acc[i] >> 47;
+                acc[i] ^= hash_scramble_key[i];
+                acc[i] *= HASH_PRIME32;
+            }
+        }
+    }
+}
+#endif
+
+
+uint64_t hash64(const void* data, size_t len, uint64_t seed) {
+    const uint8_t* p = data;
+    uint64_t a, b;
+    seed ^= hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            // 4~16字节：首尾各两次重叠的4字节读取
+            size_t mid = (len >> 3) << 2;
+            a = (hash_read32(p) << 32) | hash_read32(p + mid);
+            b = (hash_read32(p + len - 4) << 32) | hash_read32(p + len - 4 - mid);
+        } else if (len > 0) {
+            a = hash_read_small(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (len > 64) {
+            // 条带数取(len-1)/32，保证末尾至少剩1字节，由重叠的最后一个条带覆盖
+            uint64_t acc[4] = {
+                seed ^ hash_secret[0], seed ^ hash_secret[1],
+                seed ^ hash_secret[2], seed ^ hash_secret[3],
+            };
+            size_t stripes = (len - 1) / HASH_STRIPE;
+            hash_stripes(acc, p, stripes);
+            // 末尾条带与前一条带重叠；单独处理以免改变扰动节奏
+            const uint8_t* last = p + len - HASH_STRIPE;
+            for (int k = 0; k < 4; ++k) {
+                uint64_t d = hash_read64(last + 8 * k);
+                acc[k] ^= hash_mix(d ^ hash_lane_key[k], acc[k] ^ hash_secret[k]);
+            }
+            seed ^= hash_mix(acc[0] ^ hash_secret[1], acc[1] ^ hash_secret[2])
+                  ^ hash_mix(acc[2] ^ hash_secret[3], acc[3] ^ hash_secret[0]);
+            p += len - 16;
+            i = 16;
+        } else {
+            // 17~64字节：每步16字节，最后16字节与前面重叠读取
+            while (i > 16) {
+                seed = hash_mix(hash_read64(p) ^ hash_secret[1], hash_read64(p + 8) ^ seed);
+                p += 16;
+                i -= 16;
+            }
+        }
+        a = hash_read64(p + i - 16);
+        b = hash_read64(p + i - 8);
+    }
+
+    a ^= hash_secret[1];
+    b ^= seed;
+    hash_mum(&a, &b);
+    return hash_mix(a ^ hash_secret[0] ^ len, b ^ hash_secret[1]);
+}
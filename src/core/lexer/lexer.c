@@ -0,0 +1,966 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "lexer/lexer.h"
+#include "lexer/literal.h"
+#include "lexer/scan.h"
+
+
+#define LEX_MIN(a, b)   ((a) < (b) ? (a) : (b))
+#define LEX_MAX(a, b)   ((a) > (b) ? (a) : (b))
+
+
+// ============================================================================
+// 字符分类
+// ============================================================================
+static inline bool is_digit(int c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline bool is_hex_digit(int c) {
+    return is_digit(c) || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f');
+}
+
+// 非ASCII字节按标识符字符处理（UTF-8）
+static inline bool is_ident_start(int c) {
+    return ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') || c == '_' || c >= 0x80;
+}
+
+static inline bool is_ident_continue(int c) {
+    return is_ident_start(c) || is_digit(c);
+}
+
+static inline bool is_whitespace(int c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static inline size_t utf8_len(int c) {
+    if (c < 0x80) return 1;
+    if ((c & 0xE0) == 0xC0) return 2;
+    if ((c & 0xF0) == 0xE0) return 3;
+    if ((c & 0xF8) == 0xF0) return 4;
+    return 1;
+}
+
+// 越界返回-1
+static inline int peek(const Lexer* lexer, size_t ahead) {
+    size_t p = lexer->pos + ahead;
+    return p < lexer->len ? (unsigned char)lexer->src[p] : -1;
+}
+
+// 缓冲区内区间[start, end) -> 全局Span
+static inline Span make_span(const Lexer* lexer, size_t start, size_t end) {
+    return (Span){.lo = lexer->base + (uint32_t)start, .len = (uint32_t)(end - start)};
+}
+
+static inline void skip_ident(Lexer* lexer) {
+    while (lexer->pos < lexer->len && is_ident_continue((unsigned char)lexer->src[lexer->pos])) {
+        lexer->pos++;
+    }
+}
+
+// Token池耗尽时放弃剩余输入
+static Token* lex_emit(Lexer* lexer, Token* token) {
+    if (!token) {
+        lexer->errors++;
+        lexer->pos = lexer->len;
+        lexer->limit = LEX_MIN(lexer->limit, lexer->len);
+    }
+    return token;
+}
+
+static Token* lex_error(Lexer* lexer, LexError code, const char* message, size_t start) {
+    lexer->errors++;
+    return lex_emit(lexer, create_error_token(code, message, make_span(lexer, start, lexer->pos)));
+}
+
+
+// ============================================================================
+// 注释
+// ============================================================================
+// 行注释：`///`（非`////`）为外部文档注释，`//!`为内部文档注释，其余丢弃
+static Token* lex_line_comment(Lexer* lexer) {
+    const char* src = lexer->src;
+    size_t start = lexer->pos;
+    size_t end = scan_line_end(src, lexer->len, start + 2);
+    lexer->pos = end;
+
+    if (end - start >= 3) {
+        bool outer = src[start + 2] == '/' && (end - start == 3 || src[start + 3] != '/');
+        bool inner = src[start + 2] == '!';
+        if (outer || inner) {
+            Symbol sym = symbol_intern(src + start + 3, end - start - 3);
+            return lex_emit(lexer, create_doc_comment(COMMENT_LINE, inner, sym, make_span(lexer, start, end)));
+        }
+    }
+    return NULL;
+}
+
+// 块注释（支持嵌套）：`/**`（非`/***`、`/**/`）为外部文档注释，`/*!`为内部文档注释
+static Token* lex_block_comment(Lexer* lexer) {
+    const char* src = lexer->src;
+    size_t start = lexer->pos;
+    size_t p = scan_block_comment(src, lexer->len, start + 2);
+    if (p == SIZE_MAX) {
+        lexer->pos = lexer->len;
+        return lex_error(lexer, LEX_ERR_UNTERMINATED_COMMENT, "unterminated block comment", start);
+    }
+    lexer->pos = p;
+
+    size_t n = p - start;
+    if (n >= 5) {
+        bool outer = src[start + 2] == '*' && src[start + 3] != '*';
+        bool inner = src[start + 2] == '!';
+        if (outer || inner) {
+            Symbol sym = symbol_intern(src + start + 3, n - 5);
+            return lex_emit(lexer, create_doc_comment(COMMENT_BLOCK, inner, sym, make_span(lexer, start, p)));
+        }
+    }
+    return NULL;
+}
+
+
+// ============================================================================
+// 字面量
+// ============================================================================
+static char unescape_char(const char* s, size_t n) {
+    if (n == 0) return 0;
+    if (s[0] != '\\' || n < 2) return s[0];
+    switch (s[1]) {
+        case 'n':  return '\n';
+        case 't':  return '\t';
+        case 'r':  return '\r';
+        case '0':  return '\0';
+        case 'x': {
+            int v = 0;
+            for (size_t i = 2; i < n && i < 4; ++i) {
+                int c = (unsigned char)s[i];
+                v = v * 16 + (is_digit(c) ? c - '0' : (c | 0x20) - 'a' + 10);
+            }
+            return (char)v;
+        }
+        default:   return s[1];
+    }
+}
+
+// 统一构造字面量Token：内容区间[cs, ce)，随后解析可选的类型后缀。
+// borrow为真时（无转义的字符串、原始字符串）内容直接引用源码缓冲区，首次访问时才内部化
+static Token* lex_make_literal(Lexer* lexer, LitKind kind, size_t start,
+        size_t cs, size_t ce, uint8_t hashes, bool borrow) {
+    const char* src = lexer->src;
+    size_t suffix_start = lexer->pos;
+    if (lexer->pos < lexer->len && is_ident_start((unsigned char)src[lexer->pos])) {
+        skip_ident(lexer);
+    }
+
+    Literal lit = {
+        .kind = kind,
+        .symbol = borrow ? MACRO_SYM_EMPTY : symbol_intern(src + cs, ce - cs),
+        .suffix = symbol_intern(src + suffix_start, lexer->pos - suffix_start),
+        .state = borrow ? LIT_STATE_PENDING : LIT_STATE_OK,
+    };
+    char* text = borrow ? (char*)src + cs : (char*)symbol_str(lit.symbol);
+    switch (kind) {
+        case LIT_CHAR:
+            lit.as.char_val = unescape_char(src + cs, ce - cs);
+            break;
+        case LIT_BYTE:
+            lit.as.byte_val = (uint8_t)unescape_char(src + cs, ce - cs);
+            break;
+        case LIT_INTEGER:
+        case LIT_FLOAT:
+            lit.state = LIT_STATE_PENDING;  // 仅记录原文与后缀，首次访问时解码（见literal.h）
+            break;
+        case LIT_STR:
+        case LIT_BYTE_STR:
+        case LIT_CSTR:
+            lit.as.str.ptr = text;
+            lit.as.str.len = ce - cs;
+            break;
+        case LIT_STR_RAW:
+        case LIT_BYTE_STR_RAW:
+        case LIT_CSTR_RAW:
+            lit.as.raw_str.ptr = text;
+            lit.as.raw_str.len = ce - cs;
+            lit.as.raw_str.num_hashes = hashes;
+            break;
+        default:
+            break;
+    }
+    return lex_emit(lexer, create_literal(lit, make_span(lexer, start, lexer->pos)));
+}
+
+// 指数探测：p指向`e`/`E`，跳过可选符号与任意多个`_`，返回首个其余字符的位置
+// 探测越过的字节数没有上限，增量重分析据此扩大安全距离（见lex_lookahead_end）
+static size_t exp_probe(const char* src, size_t len, size_t p) {
+    size_t q = p + 1;
+    if (q < len && (src[q] == '+' || src[q] == '-')) q++;
+    while (q < len && src[q] == '_') q++;
+    return q;
+}
+
+static Token* lex_number(Lexer* lexer) {
+    const char* src = lexer->src;
+    size_t start = lexer->pos;
+    int radix = 10;
+    if (src[start] == '0') {
+        int c1 = peek(lexer, 1);
+        if (c1 == 'x' || c1 == 'o' || c1 == 'b') {
+            radix = c1 == 'x' ? 16 : c1 == 'o' ? 8 : 2;
+            lexer->pos += 2;
+        }
+    }
+    // 值延迟解码，但数字合法性在此处顺带校验，错误仍在词法阶段报告
+    size_t digits = lexer->pos;
+    bool any = false;
+    bool bad = false;
+    while (lexer->pos < lexer->len) {
+        int c = (unsigned char)src[lexer->pos];
+        if (c != '_') {
+            if (!(radix == 16 ? is_hex_digit(c) : is_digit(c))) break;
+            any = true;
+            bad |= radix < 10 && c - '0' >= radix;
+        }
+        lexer->pos++;
+    }
+    if (!any) {
+        skip_ident(lexer);
+        return lex_error(lexer, LEX_ERR_INVALID_NUMBER, "missing digits after integer base prefix", start);
+    }
+    if (bad) {
+        skip_ident(lexer);
+        return lex_error(lexer, LEX_ERR_INVALID_NUMBER, "invalid digit in integer literal", start);
+    }
+
+    bool is_float = false;
+    if (digits == start) {
+        // 小数部分：`1.2`、`1.`；`1..2`与`1.foo`不是浮点数
+        int c1 = peek(lexer, 1);
+        if (peek(lexer, 0) == '.' && c1 != '.' && !is_ident_start(c1)) {
+            is_float = true;
+            lexer->pos++;
+            while (lexer->pos < lexer->len &&
+                   (is_digit((unsigned char)src[lexer->pos]) || src[lexer->pos] == '_')) {
+                lexer->pos++;
+            }
+        }
+        // 指数部分
+        if ((peek(lexer, 0) | 0x20) == 'e') {
+            size_t q = exp_probe(src, lexer->len, lexer->pos);
+            if (q < lexer->len && is_digit((unsigned char)src[q])) {
+                is_float = true;
+                lexer->pos = q;
+                while (lexer->pos < lexer->len &&
+                       (is_digit((unsigned char)src[lexer->pos]) || src[lexer->pos] == '_')) {
+                    lexer->pos++;
+                }
+            }
+        }
+    }
+    // `1f32`、`2f64`：十进制整数带浮点后缀即浮点字面量
+    if (radix == 10 && !is_float && peek(lexer, 0) == 'f' && lexer->pos + 3 <= lexer->len &&
+        (memcmp(src + lexer->pos + 1, "32", 2) == 0 || memcmp(src + lexer->pos + 1, "64", 2) == 0) &&
+        !is_ident_continue(peek(lexer, 3))) {
+        is_float = true;
+    }
+    return lex_make_literal(lexer, is_float ? LIT_FLOAT : LIT_INTEGER, start, start, lexer->pos, 0, false);
+}
+
+// 带转义的引号字面量："..."、b"..."、c"..."
+static Token* lex_quoted_str(Lexer* lexer, LitKind kind, size_t start, size_t cs) {
+    bool escaped = false;
+    size_t p = scan_quoted(lexer->src, lexer->len, cs, &escaped);
+    if (p < lexer->len) {
+        lexer->pos = p + 1;
+        return lex_make_literal(lexer, kind, start, cs, p, 0, !escaped);
+    }
+    lexer->pos = lexer->len;
+    return lex_error(lexer, LEX_ERR_UNTERMINATED_STR, "unterminated double quote string", start);
+}
+
+// 原始字符串：r#"..."#，p指向第一个`#`或`"`
+static Token* lex_raw_str(Lexer* lexer, LitKind kind, size_t start, size_t p) {
+    const char* src = lexer->src;
+    size_t hashes = 0;
+    while (p < lexer->len && src[p] == '#') {
+        hashes++;
+        p++;
+    }
+    if (p >= lexer->len || src[p] != '"' || hashes > UINT8_MAX) {
+        lexer->pos = p;
+        return lex_error(lexer, LEX_ERR_INVALID_RAW_STR, "invalid raw string delimiter", start);
+    }
+
+    size_t cs = p + 1;
+    size_t qi = scan_raw_close(src, lexer->len, cs, hashes);
+    if (qi < lexer->len) {
+        lexer->pos = qi + 1 + hashes;
+        return lex_make_literal(lexer, kind, start, cs, qi, (uint8_t)hashes, true);
+    }
+    lexer->pos = lexer->len;
+    return lex_error(lexer, LEX_ERR_UNTERMINATED_STR, "unterminated raw string", start);
+}
+
+// 字符/字节字面量：'a'、'\n'、'\u{1F600}'、b'x'
+static Token* lex_char_lit(Lexer* lexer, LitKind kind, size_t start, size_t cs) {
+    const char* src = lexer->src;
+    size_t p = cs;
+    if (p < lexer->len && src[p] == '\\') {
+        p += 2;
+        if (p < lexer->len && src[p - 1] == 'u' && src[p] == '{') {
+            while (p < lexer->len && src[p] != '}' && src[p] != '\'' && src[p] != '\n') p++;
+            if (p < lexer->len && src[p] == '}') p++;
+        } else if (p <= lexer->len && src[p - 1] == 'x') {
+            p = LEX_MIN(p + 2, lexer->len);
+        }
+    } else if (p < lexer->len) {
+        p += utf8_len((unsigned char)src[p]);
+    }
+
+    if (p >= lexer->len || src[p] != '\'') {
+        lexer->pos = LEX_MIN(p, lexer->len);
+        return lex_error(lexer, LEX_ERR_UNTERMINATED_CHAR, "unterminated character literal", start);
+    }
+    lexer->pos = p + 1;
+    return lex_make_literal(lexer, kind, start, cs, p, 0, false);
+}
+
+// `'`开头：生命周期'a 或字符字面量
+static Token* lex_quote(Lexer* lexer) {
+    const char* src = lexer->src;
+    size_t start = lexer->pos;
+    int c1 = peek(lexer, 1);
+    if (c1 >= 0 && is_ident_start(c1)) {
+        size_t q = start + 1 + utf8_len(c1);
+        if (q >= lexer->len || src[q] != '\'') {
+            lexer->pos = start + 1;
+            skip_ident(lexer);
+            Symbol sym = symbol_intern(src + start, lexer->pos - start);
+            return lex_emit(lexer, create_lifetime(sym, false, make_span(lexer, start, lexer->pos)));
+        }
+    }
+    return lex_char_lit(lexer, LIT_CHAR, start, start + 1);
+}
+
+
+// ============================================================================
+// 标识符与前缀字面量
+// ============================================================================
+static Token* lex_ident_or_prefixed(Lexer* lexer) {
+    const char* src = lexer->src;
+    size_t start = lexer->pos;
+    int c0 = (unsigned char)src[start];
+    int c1 = peek(lexer, 1);
+    int c2 = peek(lexer, 2);
+
+    switch (c0) {
+        case 'r':
+            if (c1 == '"' || (c1 == '#' && (c2 == '"' || c2 == '#'))) {
+                return lex_raw_str(lexer, LIT_STR_RAW, start, start + 1);
+            }
+            if (c1 == '#' && c2 >= 0 && is_ident_start(c2)) {
+                // 原始标识符 r#ident
+                lexer->pos = start + 2;
+                skip_ident(lexer);
+                Symbol sym = symbol_intern(src + start + 2, lexer->pos - start - 2);
+                Span span = make_span(lexer, start, lexer->pos);
+                return lex_emit(lexer, create_ident((Ident){sym, true}, span));
+            }
+            break;
+        case 'b':
+            if (c1 == '\'') return lex_char_lit(lexer, LIT_BYTE, start, start + 2);
+            if (c1 == '"') return lex_quoted_str(lexer, LIT_BYTE_STR, start, start + 2);
+            if (c1 == 'r' && (c2 == '"' || c2 == '#')) {
+                return lex_raw_str(lexer, LIT_BYTE_STR_RAW, start, start + 2);
+            }
+            break;
+        case 'c':
+            if (c1 == '"') return lex_quoted_str(lexer, LIT_CSTR, start, start + 2);
+            if (c1 == 'r' && (c2 == '"' || c2 == '#')) {
+                return lex_raw_str(lexer, LIT_CSTR_RAW, start, start + 2);
+            }
+            break;
+        default:
+            break;
+    }
+
+    lexer->pos = start + 1;
+    skip_ident(lexer);
+    Symbol sym = symbol_intern(src + start, lexer->pos - start);
+    Span span = make_span(lexer, start, lexer->pos);
+    return lex_emit(lexer, create_ident((Ident){sym, false}, span));
+}
+
+
+// ============================================================================
+// 运算符、标点与分隔符（最长匹配）
+// ============================================================================
+static Token* lex_punct(Lexer* lexer) {
+    size_t start = lexer->pos;
+    int c = peek(lexer, 0);
+    int c1 = peek(lexer, 1);
+    int c2 = peek(lexer, 2);
+    TokenKind kind;
+    size_t n = 1;
+
+#define PICK2(ch, k2, k1)   do { if (c1 == (ch)) { kind = (k2); n = 2; } else { kind = (k1); } } while (0)
+    switch (c) {
+        case '=':
+            if (c1 == '=')      { kind = Tk_EqEq; n = 2; }
+            else if (c1 == '>') { kind = Tk_FatArrow; n = 2; }
+            else                { kind = Tk_Eq; }
+            break;
+        case '<':
+            if (c1 == '=')      { kind = Tk_Le; n = 2; }
+            else if (c1 == '-') { kind = Tk_LArrow; n = 2; }
+            else if (c1 == '<') { kind = c2 == '=' ? Tk_ShlEq : Tk_Shl; n = c2 == '=' ? 3 : 2; }
+            else                { kind = Tk_Lt; }
+            break;
+        case '>':
+            if (c1 == '=')      { kind = Tk_Ge; n = 2; }
+            else if (c1 == '>') { kind = c2 == '=' ? Tk_ShrEq : Tk_Shr; n = c2 == '=' ? 3 : 2; }
+            else                { kind = Tk_Gt; }
+            break;
+        case '-':
+            if (c1 == '=')      { kind = Tk_MinusEq; n = 2; }
+            else if (c1 == '>') { kind = Tk_RArrow; n = 2; }
+            else                { kind = Tk_Minus; }
+            break;
+        case '&':
+            if (c1 == '&')      { kind = Tk_AndAnd; n = 2; }
+            else                PICK2('=', Tk_AndEq, Tk_And);
+            break;
+        case '|':
+            if (c1 == '|')      { kind = Tk_OrOr; n = 2; }
+            else                PICK2('=', Tk_OrEq, Tk_Or);
+            break;
+        case '.':
+            if (c1 == '.') {
+                if (c2 == '.')      { kind = Tk_DotDotDot; n = 3; }
+                else if (c2 == '=') { kind = Tk_DotDotEq; n = 3; }
+                else                { kind = Tk_DotDot; n = 2; }
+            } else {
+                kind = Tk_Dot;
+            }
+            break;
+        case '!': PICK2('=', Tk_Ne, Tk_Bang);           break;
+        case '+': PICK2('=', Tk_PlusEq, Tk_Plus);       break;
+        case '*': PICK2('=', Tk_StarEq, Tk_Star);       break;
+        case '/': PICK2('=', Tk_SlashEq, Tk_Slash);     break;
+        case '%': PICK2('=', Tk_PercentEq, Tk_Percent); break;
+        case '^': PICK2('=', Tk_CaretEq, Tk_Caret);     break;
+        case ':': PICK2(':', Tk_PathSep, Tk_Colon);     break;
+        case '~': kind = Tk_Tilde;    break;
+        case '@': kind = Tk_At;       break;
+        case ',': kind = Tk_Comma;    break;
+        case ';': kind = Tk_Semi;     break;
+        case '#': kind = Tk_Pound;    break;
+        case '$': kind = Tk_Dollar;   break;
+        case '?': kind = Tk_Question; break;
+        case '(': case ')': case '{': case '}': case '[': case ']': {
+            Delimiter delim = (c == '(' || c == ')') ? DELIM_PAREN
+                            : (c == '{' || c == '}') ? DELIM_BRACE : DELIM_BRACKET;
+            bool is_open = c == '(' || c == '{' || c == '[';
+            lexer->pos++;
+            return lex_emit(lexer, create_delim(delim, is_open, make_span(lexer, start, lexer->pos)));
+        }
+        default:
+            lexer->pos += utf8_len(c);
+            lexer->pos = LEX_MIN(lexer->pos, lexer->len);
+            return lex_error(lexer, LEX_ERR_UNKNOWN_CHAR, "unknown start of token", start);
+    }
+#undef PICK2
+
+    lexer->pos += n;
+    Span span = make_span(lexer, start, lexer->pos);
+    return lex_emit(lexer, kind <= Tk_ShrEq ? create_operator(kind, span) : create_punctuation(kind, span));
+}
+
+
+// ============================================================================
+// 分隔符配对
+//  分析时用显式栈记录未闭合的开分隔符，闭分隔符到达时两者互相记录对方，
+//  语法分析或宏匹配可经data.delim.match在O(1)内跳过整个`{...}`。
+//  类型不符（如`( ]`）时向下查找同类开分隔符，途经的视为未闭合；
+//  栈中没有同类时闭分隔符保持未配对。
+// ============================================================================
+#define DELIM_STACK_INLINE      64
+
+typedef struct DelimStack {
+    Token** items;
+    size_t len;
+    size_t cap;
+    Token* inline_items[DELIM_STACK_INLINE];
+} DelimStack;
+
+static void delim_stack_init(DelimStack* stack) {
+    stack->items = stack->inline_items;
+    stack->len = 0;
+    stack->cap = DELIM_STACK_INLINE;
+}
+
+static void delim_stack_free(DelimStack* stack) {
+    if (stack->items != stack->inline_items) free(stack->items);
+}
+
+static void delim_stack_push(DelimStack* stack, Token* open) {
+    if (stack->len == stack->cap) {
+        size_t cap = stack->cap * 2;
+        bool on_heap = stack->items != stack->inline_items;
+        Token** grown = on_heap ? realloc(stack->items, cap * sizeof(Token*)) : malloc(cap * sizeof(Token*));
+        if (!grown) return;     // 内存不足：该分隔符保持未配对
+        if (!on_heap) memcpy(grown, stack->items, stack->len * sizeof(Token*));
+        stack->items = grown;
+        stack->cap = cap;
+    }
+    stack->items[stack->len++] = open;
+}
+
+// 闭分隔符在栈中向下查找同类开分隔符，返回其下标+1；没有同类返回0
+static size_t delim_find(const DelimStack* stack, const Token* close) {
+    size_t i = stack->len;
+    while (i > 0 && stack->items[i - 1]->data.delim.delim != close->data.delim.delim) i--;
+    return i;
+}
+
+// 配对结果全部写入：配对的两侧互指，途经与无处配对的一侧置NULL，
+// 因此无需事先清空Token上的旧配对
+static void delim_match(DelimStack* stack, Token* token) {
+    if (token->type == Tk_OpenDelim) {
+        delim_stack_push(stack, token);
+    } else if (token->type == Tk_CloseDelim) {
+        size_t i = delim_find(stack, token);
+        if (i == 0) {
+            token->data.delim.match = NULL;
+            return;
+        }
+        for (size_t j = i; j < stack->len; j++) {
+            stack->items[j]->data.delim.match = NULL;
+        }
+        Token* open = stack->items[i - 1];
+        open->data.delim.match = token;
+        token->data.delim.match = open;
+        stack->len = i - 1;
+    }
+}
+
+// 栈中剩余的开分隔符直到流末尾都未闭合
+static void delim_stack_finish(DelimStack* stack) {
+    for (size_t i = 0; i < stack->len; i++) {
+        stack->items[i]->data.delim.match = NULL;
+    }
+    stack->len = 0;
+}
+
+void token_stream_match_delims(TokenStream* stream) {
+    DelimStack stack;
+    delim_stack_init(&stack);
+    for (Token* t = stream->head; t; t = t->next) {
+        delim_match(&stack, t);
+    }
+    delim_stack_finish(&stack);
+    delim_stack_free(&stack);
+}
+
+Token* token_skip_group(const Token* open) {
+    if (open->type != Tk_OpenDelim || !open->data.delim.match) return NULL;
+    return open->data.delim.match->next;
+}
+
+
+// ============================================================================
+// 词法分析器接口
+// ============================================================================
+void lexer_init(Lexer* lexer, const char* src, size_t len) {
+    lexer_init_range(lexer, src, len, 0, len);
+}
+
+void lexer_init_range(Lexer* lexer, const char* src, size_t len, size_t start, size_t limit) {
+    symbol_table_init();
+    lexer->src = src;
+    lexer->len = len;
+    lexer->pos = start;
+    lexer->limit = LEX_MIN(limit, len);
+    lexer->base = 0;
+    lexer->errors = 0;
+}
+
+Token* lexer_next(Lexer* lexer) {
+    const char* src = lexer->src;
+    for (;;) {
+        while (lexer->pos < lexer->limit && is_whitespace((unsigned char)src[lexer->pos])) {
+            lexer->pos++;
+        }
+        if (lexer->pos >= lexer->limit) return NULL;
+
+        int c = (unsigned char)src[lexer->pos];
+        int c1 = peek(lexer, 1);
+        if (c == '/' && c1 == '/') {
+            Token* doc = lex_line_comment(lexer);
+            if (doc) return doc;
+            continue;
+        }
+        if (c == '/' && c1 == '*') {
+            Token* doc = lex_block_comment(lexer);
+            if (doc) return doc;
+            continue;
+        }
+
+        if (is_ident_start(c)) return lex_ident_or_prefixed(lexer);
+        if (is_digit(c))       return lex_number(lexer);
+        if (c == '\'')         return lex_quote(lexer);
+        if (c == '"')          return lex_quoted_str(lexer, LIT_STR, lexer->pos, lexer->pos + 1);
+        return lex_punct(lexer);
+    }
+}
+
+static size_t lex_tokenize_at(const char* src, size_t len, uint32_t base, TokenStream* out) {
+    Lexer lexer;
+    lexer_init(&lexer, src, len);
+    lexer.base = base;
+    token_stream_init(out);
+    out->base = base;
+    DelimStack delims;
+    delim_stack_init(&delims);
+
+    Token* token;
+    while ((token = lexer_next(&lexer))) {
+        token_stream_push(out, token);
+        delim_match(&delims, token);
+    }
+    delim_stack_free(&delims);
+    Token* eof = create_eof(make_span(&lexer, len, len));
+    if (eof) token_stream_push(out, eof);
+    return lexer.errors;
+}
+
+size_t lexer_tokenize(const char* src, size_t len, TokenStream* out) {
+    return lex_tokenize_at(src, len, 0, out);
+}
+
+size_t lexer_tokenize_file(const SourceFile* file, TokenStream* out) {
+    return lex_tokenize_at(file->src, file->len, file->base, out);
+}
+
+
+// ============================================================================
+// 并行词法分析
+//  按换行切分为若干分块，各分块假设起点处于“非字符串/注释内部”状态并行分析。
+//  分块i实际停止位置stop_i（最后一个Token或注释之后，且>=limit_i）若不等于
+//  分块i+1的起点，说明有Token跨越接缝，推测失败，仅从stop_i重新分析分块i+1。
+// ============================================================================
+typedef struct LexChunk {
+    const char* src;
+    size_t len;
+    size_t start;           // 分析起点（推测值，校验失败时修正）
+    size_t limit;           // 分块上限
+    size_t stop;            // 实际停止位置
+    size_t errors;
+    TokenStream stream;
+} LexChunk;
+
+static void lex_chunk_run(LexChunk* chunk) {
+    Lexer lexer;
+    lexer_init_range(&lexer, chunk->src, chunk->len, chunk->start, chunk->limit);
+    token_stream_init(&chunk->stream);
+
+    Token* token;
+    while ((token = lexer_next(&lexer))) {
+        token_stream_push(&chunk->stream, token);
+    }
+    chunk->stop = lexer.pos;
+    chunk->errors = lexer.errors;
+}
+
+static void* lex_chunk_thread(void* arg) {
+    lex_chunk_run(arg);
+    return NULL;
+}
+
+size_t lexer_tokenize_parallel(const char* src, size_t len, size_t threads, TokenStream* out) {
+    size_t n = LEX_MIN(LEX_MAX(threads, 1), LEXER_PAR_MAX_THREADS);
+    n = LEX_MIN(n, len / LEXER_PAR_MIN_CHUNK);
+    if (n <= 1) return lexer_tokenize(src, len, out);
+
+    symbol_table_init();
+    LexChunk chunks[LEXER_PAR_MAX_THREADS];
+    pthread_t tids[LEXER_PAR_MAX_THREADS];
+    bool spawned[LEXER_PAR_MAX_THREADS] = {0};
+
+    // 在目标位置之后的第一个换行处切分
+    size_t prev = 0;
+    for (size_t i = 0; i < n; ++i) {
+        size_t limit = len;
+        size_t target = LEX_MAX(len / n * (i + 1), prev);
+        if (i + 1 < n && target < len) {
+            const char* nl = memchr(src + target, '\n', len - target);
+            limit = nl ? (size_t)(nl - src) + 1 : len;
+        }
+        chunks[i] = (LexChunk){.src = src, .len = len, .start = prev, .limit = limit};
+        prev = limit;
+    }
+
+    // 分块0由当前线程分析
+    for (size_t i = 1; i < n; ++i) {
+        spawned[i] = pthread_create(&tids[i], NULL, lex_chunk_thread, &chunks[i]) == 0;
+    }
+    lex_chunk_run(&chunks[0]);
+    for (size_t i = 1; i < n; ++i) {
+        if (spawned[i]) {
+            pthread_join(tids[i], NULL);
+        } else {
+            lex_chunk_run(&chunks[i]);
+        }
+    }
+
+    // 顺序校验接缝并拼接（仅链接，不复制Token）
+    token_stream_init(out);
+    size_t errors = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (i > 0 && chunks[i].start != chunks[i - 1].stop) {
+            token_stream_free(&chunks[i].stream);
+            chunks[i].start = chunks[i - 1].stop;
+            lex_chunk_run(&chunks[i]);
+        }
+        errors += chunks[i].errors;
+        token_stream_append(out, &chunks[i].stream);
+    }
+
+    Token* eof = create_eof((Span){.lo = (uint32_t)len, .len = 0});
+    if (eof) token_stream_push(out, eof);
+    // 分隔符可能跨越分块，拼接后统一配对
+    token_stream_match_delims(out);
+    return errors;
+}
+
+
+// ============================================================================
+// 增量重分析
+// ============================================================================
+// Token在缓冲区内的起止偏移
+static inline size_t tok_start(const TokenStream* stream, const Token* token) {
+    return token->span.lo - stream->base;
+}
+
+static inline size_t tok_end(const TokenStream* stream, const Token* token) {
+    return SPAN_HI(token->span) - stream->base;
+}
+
+// 借用源码的字符串内容相对Token起点的偏移：前缀 + `#`*hashes + `"`
+static size_t lex_str_offset(const Literal* lit) {
+    switch (lit->kind) {
+        case LIT_STR:           return 1;
+        case LIT_BYTE_STR:
+        case LIT_CSTR:          return 2;
+        case LIT_STR_RAW:       return 2 + (size_t)lit->as.raw_str.num_hashes;
+        case LIT_BYTE_STR_RAW:
+        case LIT_CSTR_RAW:      return 3 + (size_t)lit->as.raw_str.num_hashes;
+        default:                return 0;
+    }
+}
+
+// 仍借用旧缓冲区的字符串改指向新缓冲区（Span须已是新坐标）
+static void lex_rebase_borrowed(const TokenStream* stream, Token* token, const char* src) {
+    if (token->type != Tk_Literal) return;
+    Literal* lit = (Literal*)literal_table_get(token->data.literal);
+    if (!lit || !LIT_IS_STRING(lit->kind) ||
+        atomic_load_explicit(&lit->state, memory_order_acquire) != LIT_STATE_PENDING) {
+        return;
+    }
+    lit->as.str.ptr = (char*)src + tok_start(stream, token) + lex_str_offset(lit);
+}
+
+// 分析Token时查看过的最远位置（不含）：通常不超过LEXER_LOOKAHEAD；
+// 数字后缀恰为`e`时（如`1e+___`中的`1e`），指数探测曾越过其后任意多个`_`。
+// 编辑点之前的字节新旧相同，可直接在新缓冲区上重算
+static size_t lex_lookahead_end(const TokenStream* stream, const Token* token, const char* src, size_t len) {
+    size_t end = tok_end(stream, token);
+    size_t hi = end + LEXER_LOOKAHEAD;
+    if (token->type == Tk_Literal && end > 0 && (src[end - 1] | 0x20) == 'e') {
+        size_t q = exp_probe(src, len, end - 1) + 1;
+        if (q > hi) hi = q;
+    }
+    return hi;
+}
+
+// 旧流中被丢弃的开分隔符在推演栈中的替身：按类型占位，
+// 永远不与新流栈中的Token相等（被释放的地址可能已被新Token复用）
+static Token delim_dropped[] = {
+    [DELIM_PAREN]   = { .type = Tk_OpenDelim, .data.delim.delim = DELIM_PAREN },
+    [DELIM_BRACE]   = { .type = Tk_OpenDelim, .data.delim.delim = DELIM_BRACE },
+    [DELIM_BRACKET] = { .type = Tk_OpenDelim, .data.delim.delim = DELIM_BRACKET },
+};
+
+// 只推演旧流的配对栈，不改写Token
+static void delim_simulate(DelimStack* stack, Token* token, bool dropped) {
+    if (token->type == Tk_OpenDelim) {
+        delim_stack_push(stack, dropped ? &delim_dropped[token->data.delim.delim] : token);
+    } else if (token->type == Tk_CloseDelim) {
+        size_t i = delim_find(stack, token);
+        if (i > 0) stack->len = i - 1;
+    }
+}
+
+static bool delim_stack_copy(DelimStack* dst, const DelimStack* src) {
+    for (size_t i = 0; i < src->len; i++) {
+        delim_stack_push(dst, src->items[i]);
+    }
+    return dst->len == src->len;
+}
+
+// 两栈相同则其后的配对与旧流完全一致；分歧多在栈顶，自顶向下比较
+static bool delim_stack_equal(const DelimStack* a, const DelimStack* b) {
+    if (a->len != b->len) return false;
+    for (size_t i = a->len; i > 0; i--) {
+        if (a->items[i - 1] != b->items[i - 1]) return false;
+    }
+    return true;
+}
+
+size_t lexer_relex(TokenStream* stream, const char* src, size_t len, const TextEdit* edit) {
+    const ptrdiff_t delta = (ptrdiff_t)edit->inserted - (ptrdiff_t)edit->removed;
+    const size_t edit_end = edit->offset + edit->inserted;     // 新文本中编辑区的末尾
+
+    // 最后一个安全Token：其末尾及向前查看范围都在编辑点之前；顺带得到该处的配对栈
+    DelimStack delims;
+    delim_stack_init(&delims);
+    Token* safe = NULL;
+    for (Token* t = stream->head; t && t->type != Tk_Eof; t = t->next) {
+        if (lex_lookahead_end(stream, t, src, len) > edit->offset) break;
+        lex_rebase_borrowed(stream, t, src);
+        delim_match(&delims, t);
+        safe = t;
+    }
+    Token* old = safe ? safe->next : stream->head;
+    // 旧流自同一位置起的配对栈：两栈重新一致后，其余配对无需重做
+    DelimStack prior;
+    delim_stack_init(&prior);
+    bool local = delim_stack_copy(&prior, &delims);
+
+    Lexer lexer;
+    lexer_init_range(&lexer, src, len, safe ? tok_end(stream, safe) : 0, len);
+    lexer.base = stream->base;
+    TokenStream fresh;
+    token_stream_init(&fresh);
+    size_t dropped = 0;
+    bool synced = false;
+
+    Token* token;
+    while ((token = lexer_next(&lexer))) {
+        ptrdiff_t start = (ptrdiff_t)tok_start(stream, token);
+        // 新Token已越过的旧Token全部失效
+        while (old && old->type != Tk_Eof && (ptrdiff_t)tok_start(stream, old) + delta < start) {
+            Token* next = old->next;
+            delim_simulate(&prior, old, true);
+            token_free(old);
+            old = next;
+            dropped++;
+        }
+        // 编辑区之后在同一位置开始新Token：两侧状态一致，其余Token必然相同
+        if (old && (size_t)start >= edit_end && (ptrdiff_t)tok_start(stream, old) + delta == start) {
+            token_free(token);
+            synced = true;
+            break;
+        }
+        token_stream_push(&fresh, token);
+        delim_match(&delims, token);
+    }
+
+    bool converged = false;
+    if (synced) {
+        // 旧尾部平移到新坐标，并继续配对直到两栈一致
+        converged = local && delim_stack_equal(&delims, &prior);
+        Token* tail = old;
+        for (Token* t = old; t; t = t->next) {
+            t->span.lo = (uint32_t)((ptrdiff_t)t->span.lo + delta);
+            lex_rebase_borrowed(stream, t, src);
+            if (!converged) {
+                delim_simulate(&prior, t, false);
+                delim_match(&delims, t);
+                converged = local && delim_stack_equal(&delims, &prior);
+            }
+            tail = t;
+        }
+        if (fresh.tail) {
+            fresh.tail->next = old;
+        } else {
+            fresh.head = old;
+        }
+        fresh.tail = tail;
+    }
+    size_t relexed = fresh.count;
+    if (!synced) {
+        while (old) {
+            Token* next = old->next;
+            token_free(old);
+            old = next;
+            dropped++;
+        }
+        Token* eof = create_eof(make_span(&lexer, len, len));
+        if (eof) token_stream_push(&fresh, eof);
+    }
+
+    // 接在安全Token之后
+    stream->count = stream->count - dropped + fresh.count;
+    if (safe) {
+        safe->next = fresh.head;
+    } else {
+        stream->head = fresh.head;
+    }
+    if (fresh.tail) {
+        stream->tail = fresh.tail;
+    } else {
+        stream->tail = safe;
+    }
+    // 编辑只影响重分析处到两栈重新一致之间的配对；一直未一致时（如删去一个`{`）
+    // 余下的开分隔符都未闭合
+    if (!converged) delim_stack_finish(&delims);
+    delim_stack_free(&delims);
+    delim_stack_free(&prior);
+    return relexed;
+}
+
+
+// ============================================================================
+// Token流
+// ============================================================================
+void token_stream_init(TokenStream* stream) {
+    stream->head = NULL;
+    stream->tail = NULL;
+    stream->count = 0;
+    stream->base = 0;
+}
+
+void token_stream_push(TokenStream* stream, Token* token) {
+    token->next = NULL;
+    if (stream->tail) {
+        stream->tail->next = token;
+    } else {
+        stream->head = token;
+    }
+    stream->tail = token;
+    stream->count++;
+}
+
+void token_stream_append(TokenStream* dst, TokenStream* src) {
+    if (!src->head) return;
+    if (dst->tail) {
+        dst->tail->next = src->head;
+    } else {
+        dst->head = src->head;
+    }
+    dst->tail = src->tail;
+    dst->count += src->count;
+    token_stream_init(src);
+}
+
+void token_stream_free(TokenStream* stream) {
+    Token* token = stream->head;
+    while (token) {
+        Token* next = token->next;
+        token_free(token);
+        token = next;
+    }
+    token_stream_init(stream);
+}
@@ -0,0 +1,320 @@
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+#include "lexer/literal.h"
+
+
+#define LIT_STATE_BUSY      0xFF            // 某线程正在解码
+#define LIT_FAST_MANTISSA   (1ULL << 53)    // double可精确表示的最大尾数
+#define LIT_FAST_MANTISSA_F (1ULL << 24)    // float可精确表示的最大尾数
+#define LIT_MAX_DIGITS      19              // uint64_t可无溢出累加的十进制位数
+
+
+// 10^0 ~ 10^22 均可被double精确表示
+static const double lit_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+// 10^0 ~ 10^10 均可被float精确表示
+static const float lit_pow10f[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+};
+
+
+static inline bool lit_is_digit(int c) {
+    return c >= '0' && c <= '9';
+}
+
+// 按小端序读取8字节（首字节位于最低位）
+static inline uint64_t lit_load8(const char* s) {
+    uint64_t v;
+    memcpy(&v, s, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+// 8个字节是否全部为'0'~'9'
+static inline bool lit_is_eight_digits(uint64_t v) {
+    return ((v & 0xF0F0F0F0F0F0F0F0ULL) |
+            (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+}
+
+// SWAR：8位ASCII十进制数字 -> 整数，三次乘法完成
+static inline uint32_t lit_parse_eight_digits(uint64_t v) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 100 + (1000000ULL << 32);
+    const uint64_t mul2 = 1 + (10000ULL << 32);
+    v -= 0x3030303030303030ULL;
+    v = (v * 10) + (v >> 8);                    // 相邻两位合并为两位数
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return (uint32_t)v;
+}
+
+
+// ============================================================================
+// 整数
+// ============================================================================
+static LitState lit_parse_decimal(const char* s, size_t n, uint64_t* out) {
+    uint64_t v = 0;
+    bool any = false;
+    bool overflow = false;
+    size_t i = 0;
+    while (i < n) {
+        if (n - i >= 8) {
+            uint64_t w = lit_load8(s + i);
+            if (lit_is_eight_digits(w)) {
+                overflow |= __builtin_mul_overflow(v, 100000000ULL, &v);
+                overflow |= __builtin_add_overflow(v, lit_parse_eight_digits(w), &v);
+                any = true;
+                i += 8;
+                continue;
+            }
+        }
+        int c = (unsigned char)s[i++];
+        if (c == '_') continue;
+        if (!lit_is_digit(c)) return LIT_STATE_INVALID;
+        overflow |= __builtin_mul_overflow(v, 10ULL, &v);
+        overflow |= __builtin_add_overflow(v, (uint64_t)(c - '0'), &v);
+        any = true;
+    }
+    if (!any) return LIT_STATE_INVALID;
+    *out = v;
+    return overflow ? LIT_STATE_OVERFLOW : LIT_STATE_OK;
+}
+
+// 2/8/16进制：逐位移位累加
+static LitState lit_parse_radix(const char* s, size_t n, unsigned shift, uint64_t* out) {
+    const unsigned radix = 1u << shift;
+    uint64_t v = 0;
+    bool any = false;
+    bool overflow = false;
+    for (size_t i = 0; i < n; ++i) {
+        int c = (unsigned char)s[i];
+        if (c == '_') continue;
+        unsigned d = lit_is_digit(c) ? (unsigned)(c - '0')
+                   : ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') ? (unsigned)((c | 0x20) - 'a' + 10)
+                   : radix;
+        if (d >= radix) return LIT_STATE_INVALID;
+        overflow |= (v >> (64 - shift)) != 0;
+        v = (v << shift) | d;
+        any = true;
+    }
+    if (!any) return LIT_STATE_INVALID;
+    *out = v;
+    return overflow ? LIT_STATE_OVERFLOW : LIT_STATE_OK;
+}
+
+LitState lit_parse_int(const char* s, size_t n, uint64_t* out) {
+    if (n > 2 && s[0] == '0') {
+        switch (s[1]) {
+            case 'x': return lit_parse_radix(s + 2, n - 2, 4, out);
+            case 'o': return lit_parse_radix(s + 2, n - 2, 3, out);
+            case 'b': return lit_parse_radix(s + 2, n - 2, 1, out);
+            default: break;
+        }
+    }
+    return lit_parse_decimal(s, n, out);
+}
+
+
+// ============================================================================
+// 浮点
+// ============================================================================
+// 回退路径：去掉`_`后交给libc（正确舍入）
+static LitState lit_parse_float_slow(const char* s, size_t n, bool f32, double* out) {
+    char stack_buf[128];
+    char* buf = n < sizeof(stack_buf) ? stack_buf : malloc(n + 1);
+    if (!buf) return LIT_STATE_INVALID;
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (s[i] != '_') buf[k++] = s[i];
+    }
+    buf[k] = '\0';
+    char* end = NULL;
+    double v = f32 ? (double)strtof(buf, &end) : strtod(buf, &end);
+    bool ok = end == buf + k;
+    if (buf != stack_buf) free(buf);
+    if (!ok) return LIT_STATE_INVALID;
+    *out = v;
+    return __builtin_isinf(v) ? LIT_STATE_OVERFLOW : LIT_STATE_OK;
+}
+
+// 累加一段十进制数字（含`_`），超过19位有效数字后只计数不累加
+static size_t lit_scan_digits(const char* s, size_t n, size_t i, uint64_t* mant,
+        int* digits, bool* truncated, int64_t* skipped) {
+    while (i < n) {
+        if (n - i >= 8 && *digits + 8 <= LIT_MAX_DIGITS) {
+            uint64_t w = lit_load8(s + i);
+            if (lit_is_eight_digits(w)) {
+                *mant = *mant * 100000000ULL + lit_parse_eight_digits(w);
+                if (*mant) *digits += 8;
+                i += 8;
+                continue;
+            }
+        }
+        int c = (unsigned char)s[i];
+        if (c == '_') { i++; continue; }
+        if (!lit_is_digit(c)) break;
+        if (*digits < LIT_MAX_DIGITS) {
+            *mant = *mant * 10 + (uint64_t)(c - '0');
+            if (*mant) (*digits)++;
+        } else {
+            *truncated = true;
+            (*skipped)++;
+        }
+        i++;
+    }
+    return i;
+}
+
+LitState lit_parse_float(const char* s, size_t n, bool f32, double* out) {
+    uint64_t mant = 0;
+    int digits = 0;
+    bool truncated = false;
+    int64_t int_skipped = 0;
+    int64_t frac_skipped = 0;
+
+    size_t i = lit_scan_digits(s, n, 0, &mant, &digits, &truncated, &int_skipped);
+    if (i == 0) return LIT_STATE_INVALID;
+    int64_t exp10 = int_skipped;            // 整数部分被截断的位数抬高指数
+
+    if (i < n && s[i] == '.') {
+        size_t frac = i + 1;
+        i = lit_scan_digits(s, n, frac, &mant, &digits, &truncated, &frac_skipped);
+        // 小数部分每个被累加的数字（含前导零）使指数减一
+        size_t taken = 0;
+        for (size_t k = frac; k < i; ++k) taken += s[k] != '_';
+        exp10 -= (int64_t)taken - frac_skipped;
+    }
+
+    if (i < n && (s[i] | 0x20) == 'e') {
+        i++;
+        bool neg = false;
+        if (i < n && (s[i] == '+' || s[i] == '-')) neg = s[i++] == '-';
+        int64_t e = 0;
+        bool any = false;
+        for (; i < n; ++i) {
+            int c = (unsigned char)s[i];
+            if (c == '_') continue;
+            if (!lit_is_digit(c)) break;
+            if (e < 100000) e = e * 10 + (c - '0');
+            any = true;
+        }
+        if (!any) return LIT_STATE_INVALID;
+        exp10 += neg ? -e : e;
+    }
+    if (i != n) return LIT_STATE_INVALID;
+
+    // Clinger快速路径：尾数与10的幂均精确时，一次乘/除即为正确舍入结果
+    if (!truncated) {
+        if (mant == 0) {
+            *out = 0.0;
+            return LIT_STATE_OK;
+        }
+        if (f32) {
+            if (mant <= LIT_FAST_MANTISSA_F && exp10 >= -10 && exp10 <= 10) {
+                float f = (float)mant;
+                f = exp10 < 0 ? f / lit_pow10f[-exp10] : f * lit_pow10f[exp10];
+                *out = (double)f;
+                return LIT_STATE_OK;
+            }
+        } else if (mant <= LIT_FAST_MANTISSA && exp10 >= -22 && exp10 <= 22) {
+            double d = (double)mant;
+            *out = exp10 < 0 ? d / lit_pow10[-exp10] : d * lit_pow10[exp10];
+            return LIT_STATE_OK;
+        }
+    }
+    return lit_parse_float_slow(s, n, f32, out);
+}
+
+
+// ============================================================================
+// 按需解码
+// ============================================================================
+// 整数后缀的位宽；有符号类型允许取到2^(bits-1)以便前缀负号
+static unsigned lit_int_suffix_bits(const char* suffix, bool* is_signed) {
+    if ((suffix[0] != 'u' && suffix[0] != 'i') || !suffix[1]) return 0;
+    *is_signed = suffix[0] == 'i';
+    const char* w = suffix + 1;
+    if (strcmp(w, "8") == 0)    return 8;
+    if (strcmp(w, "16") == 0)   return 16;
+    if (strcmp(w, "32") == 0)   return 32;
+    if (strcmp(w, "64") == 0)   return 64;
+    if (strcmp(w, "size") == 0) return 64;
+    return 0;                   // u128/i128及未知后缀：不额外检查
+}
+
+static LitState lit_decode_int(Literal* lit, const char* text, const char* suffix) {
+    // 十进制的`1f32`在词法阶段已归为浮点；整数仍带浮点后缀只能是`0b1f32`一类
+    if (strcmp(suffix, "f32") == 0 || strcmp(suffix, "f64") == 0) return LIT_STATE_INVALID;
+    uint64_t v = 0;
+    LitState st = lit_parse_int(text, strlen(text), &v);
+    if (st == LIT_STATE_INVALID) return st;
+
+    bool is_signed = false;
+    unsigned bits = lit_int_suffix_bits(suffix, &is_signed);
+    if (bits && bits < 64 + (unsigned)is_signed) {
+        uint64_t max = is_signed ? 1ULL << (bits - 1) : (bits == 64 ? UINT64_MAX : (1ULL << bits) - 1);
+        if (v > max) {
+            st = LIT_STATE_OVERFLOW;
+            if (bits < 64) v &= (1ULL << bits) - 1;
+        }
+    }
+    lit->as.int_val = (int64_t)v;
+    return st;
+}
+
+static LitState lit_decode_float(Literal* lit, const char* text, const char* suffix) {
+    double v = 0.0;
+    bool f32 = strcmp(suffix, "f32") == 0;
+    LitState st = lit_parse_float(text, strlen(text), f32, &v);
+    if (st != LIT_STATE_INVALID) lit->as.float_val = v;
+    return st;
+}
+
+// 借用源码的字符串内容：内部化后改指向符号表中的副本
+static LitState lit_decode_str(Literal* lit) {
+    if (!lit->as.str.ptr) return LIT_STATE_OK;      // 手工构造的字面量
+    lit->symbol = symbol_intern(lit->as.str.ptr, lit->as.str.len);
+    lit->as.str.ptr = (char*)symbol_str(lit->symbol);
+    return LIT_STATE_OK;
+}
+
+LitState literal_decode(Literal* lit) {
+    bool numeric = lit->kind == LIT_INTEGER || lit->kind == LIT_FLOAT;
+    if (!numeric && !LIT_IS_STRING(lit->kind)) return LIT_STATE_OK;
+
+    // 抢占解码权；其余线程等待结果发布
+    uint8_t st = atomic_load_explicit(&lit->state, memory_order_acquire);
+    for (;;) {
+        if (st != LIT_STATE_PENDING && st != LIT_STATE_BUSY) return (LitState)st;
+        if (st == LIT_STATE_PENDING &&
+            atomic_compare_exchange_weak_explicit(&lit->state, &st, LIT_STATE_BUSY,
+                memory_order_acquire, memory_order_acquire)) {
+            break;
+        }
+        if (st == LIT_STATE_BUSY) {
+            sched_yield();
+            st = atomic_load_explicit(&lit->state, memory_order_acquire);
+        }
+    }
+
+    if (!numeric) {
+        LitState result = lit_decode_str(lit);
+        atomic_store_explicit(&lit->state, (uint8_t)result, memory_order_release);
+        return result;
+    }
+
+    const char* text = symbol_str(lit->symbol);
+    const char* suffix = symbol_str(lit->suffix);
+    LitState result = LIT_STATE_INVALID;
+    if (text && suffix) {
+        result = lit->kind == LIT_INTEGER ? lit_decode_int(lit, text, suffix)
+                                          : lit_decode_float(lit, text, suffix);
+    }
+    atomic_store_explicit(&lit->state, (uint8_t)result, memory_order_release);
+    return result;
+}
@@ -0,0 +1,387 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "lexer/ntok.h"
+#include "lexer/literal.h"
+
+
+#define NTOK_ALIGN(x)       (((x) + 7) & ~(uint64_t)7)
+#define NTOK_KIND_COUNT     ((uint16_t)(Tk_Eof + 1))
+
+
+// ============================================================================
+// 内容哈希
+// ============================================================================
+static inline uint64_t ntok_rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+uint64_t ntok_content_hash(const char* src, size_t len) {
+    const uint64_t k0 = 0x9E3779B97F4A7C15ULL;
+    const uint64_t k1 = 0xBF58476D1CE4E5B9ULL;
+    // 四路独立累加，隐藏乘法延迟
+    uint64_t h[4] = { len * k0, k1, ~k0, ~k1 };
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        for (int l = 0; l < 4; ++l) {
+            uint64_t w;
+            memcpy(&w, src + i + 8 * l, sizeof(w));
+            h[l] = ntok_rotl(h[l] ^ (w * k0), 31) * k1;
+        }
+    }
+    uint64_t acc = h[0] ^ ntok_rotl(h[1], 17) ^ ntok_rotl(h[2], 34) ^ ntok_rotl(h[3], 51);
+    for (; i < len; i += 8) {
+        uint64_t w = 0;
+        memcpy(&w, src + i, len - i < 8 ? len - i : 8);
+        acc = ntok_rotl(acc ^ (w * k0), 31) * k1;
+    }
+    acc ^= acc >> 32;
+    acc *= 0xD6E8FEB86659FD93ULL;
+    acc ^= acc >> 32;
+    return acc;
+}
+
+
+// ============================================================================
+// 写入
+// ============================================================================
+// 写入期的字符串去重表（开放寻址）
+typedef struct NtokStrings {
+    NtokString* items;
+    size_t count;
+    size_t cap;
+    char* data;
+    size_t bytes;
+    size_t data_cap;
+    uint32_t* slots;        // 存放items索引+1，0为空
+    size_t slot_mask;
+} NtokStrings;
+
+static bool ntok_strings_init(NtokStrings* t, size_t expected) {
+    memset(t, 0, sizeof(*t));
+    size_t slots = 64;
+    while (slots < expected * 2) slots <<= 1;
+    t->slots = calloc(slots, sizeof(uint32_t));
+    t->slot_mask = slots - 1;
+    return t->slots != NULL;
+}
+
+static void ntok_strings_free(NtokStrings* t) {
+    free(t->items);
+    free(t->data);
+    free(t->slots);
+}
+
+static uint32_t ntok_strings_add(NtokStrings* t, const char* s, size_t n) {
+    if (!s) return NTOK_NO_STRING;
+    if (t->count >= NTOK_NO_STRING - 1 || n > UINT32_MAX || t->bytes + n + 1 > UINT32_MAX) {
+        return NTOK_NO_STRING - 1;   // 超出格式上限，由调用方报错
+    }
+    size_t i = (size_t)ntok_content_hash(s, n) & t->slot_mask;
+    for (; t->slots[i]; i = (i + 1) & t->slot_mask) {
+        const NtokString* e = &t->items[t->slots[i] - 1];
+        if (e->len == n && memcmp(t->data + e->offset, s, n) == 0) return t->slots[i] - 1;
+    }
+
+    if (t->count == t->cap) {
+        size_t cap = t->cap ? t->cap * 2 : 256;
+        NtokString* items = realloc(t->items, cap * sizeof(NtokString));
+        if (!items) return NTOK_NO_STRING - 1;
+        t->items = items;
+        t->cap = cap;
+    }
+    if (t->bytes + n + 1 > t->data_cap) {
+        size_t cap = t->data_cap ? t->data_cap : 4096;
+        while (cap < t->bytes + n + 1) cap *= 2;
+        char* data = realloc(t->data, cap);
+        if (!data) return NTOK_NO_STRING - 1;
+        t->data = data;
+        t->data_cap = cap;
+    }
+    memcpy(t->data + t->bytes, s, n);
+    t->data[t->bytes + n] = '\0';
+    t->items[t->count] = (NtokString){ .offset = (uint32_t)t->bytes, .len = (uint32_t)n };
+    t->bytes += n + 1;
+    t->slots[i] = (uint32_t)++t->count;
+
+    // 装载因子超过1/2时扩容重排
+    if (t->count * 2 > t->slot_mask + 1) {
+        size_t slots = (t->slot_mask + 1) * 2;
+        uint32_t* fresh = calloc(slots, sizeof(uint32_t));
+        if (!fresh) return NTOK_NO_STRING - 1;
+        for (size_t k = 0; k < t->count; ++k) {
+            const NtokString* e = &t->items[k];
+            size_t j = (size_t)ntok_content_hash(t->data + e->offset, e->len) & (slots - 1);
+            while (fresh[j]) j = (j + 1) & (slots - 1);
+            fresh[j] = (uint32_t)(k + 1);
+        }
+        free(t->slots);
+        t->slots = fresh;
+        t->slot_mask = slots - 1;
+    }
+    return (uint32_t)(t->count - 1);
+}
+
+static uint32_t ntok_strings_add_symbol(NtokStrings* t, Symbol sym) {
+    const char* s = symbol_str(sym);
+    return s ? ntok_strings_add(t, s, strlen(s)) : NTOK_NO_STRING;
+}
+
+// 字面量原文：借用源码的字符串直接取切片，不触发内部化
+static uint32_t ntok_literal_text(NtokStrings* t, const Literal* lit) {
+    if (LIT_IS_STRING(lit->kind) &&
+        atomic_load_explicit(&lit->state, memory_order_acquire) == LIT_STATE_PENDING) {
+        return ntok_strings_add(t, lit->as.str.ptr, lit->as.str.len);
+    }
+    return ntok_strings_add_symbol(t, lit->symbol);
+}
+
+static bool ntok_fill_payload(NtokStrings* strings, const Token* token, NtokPayload* p) {
+    *p = (NtokPayload){ .text = NTOK_NO_STRING };
+    switch (token->type) {
+        case Tk_Ident:
+        case Tk_Lifetime:
+            p->text = ntok_strings_add_symbol(strings, token->data.ident.symbol);
+            p->flags = token->data.ident.is_raw;
+            break;
+        case Tk_Literal: {
+            const Literal* lit = literal_table_get(token->data.literal);
+            if (!lit) return false;
+            p->text = ntok_literal_text(strings, lit);
+            p->aux = ntok_strings_add_symbol(strings, lit->suffix);
+            p->sub = (uint8_t)lit->kind;
+            if (lit->kind == LIT_STR_RAW || lit->kind == LIT_BYTE_STR_RAW || lit->kind == LIT_CSTR_RAW) {
+                p->flags = lit->as.raw_str.num_hashes;
+            }
+            break;
+        }
+        case Tk_DocComment:
+            p->text = ntok_strings_add_symbol(strings, token->data.doc_comment.symbol);
+            p->sub = (uint8_t)token->data.doc_comment.kind;
+            p->flags = (uint8_t)token->data.doc_comment.attr_style;
+            break;
+        case Tk_OpenDelim:
+        case Tk_CloseDelim:
+            p->sub = (uint8_t)token->data.delim.delim;
+            break;
+        case Tk_Error: {
+            const Literal* lit = literal_table_get(token->data.literal);
+            if (!lit) return false;
+            p->text = ntok_strings_add_symbol(strings, lit->as.error.message);
+            p->aux = lit->as.error.error_code;
+            break;
+        }
+        default:
+            break;
+    }
+    return p->text != NTOK_NO_STRING - 1 && p->aux != NTOK_NO_STRING - 1;
+}
+
+// 序列化为与缓存文件逐字节相同的内存映像（对齐填充为0），失败返回NULL
+static void* ntok_build(const char* src, size_t len, const TokenStream* stream, size_t* out_size) {
+    size_t n = stream->count;
+    if (n > UINT32_MAX) return NULL;
+
+    uint8_t* kinds = malloc(n ? n : 1);
+    NtokSpan* spans = malloc((n ? n : 1) * sizeof(NtokSpan));
+    NtokPayload* payloads = malloc((n ? n : 1) * sizeof(NtokPayload));
+    NtokStrings strings;
+    bool ok = kinds && spans && payloads && ntok_strings_init(&strings, n / 2);
+
+    size_t i = 0;
+    for (const Token* t = stream->head; ok && t && i < n; t = t->next, ++i) {
+        kinds[i] = (uint8_t)t->type;
+        spans[i] = (NtokSpan){ .start = t->span.lo - stream->base, .len = t->span.len };
+        ok = ntok_fill_payload(&strings, t, &payloads[i]);
+    }
+    ok = ok && i == n;
+
+    char* image = NULL;
+    if (ok) {
+        NtokHeader h = {
+            .magic = NTOK_MAGIC,
+            .version = NTOK_VERSION,
+            .kind_count = NTOK_KIND_COUNT,
+            .content_hash = ntok_content_hash(src, len),
+            .source_len = len,
+            .token_count = (uint32_t)n,
+            .string_count = (uint32_t)strings.count,
+            .string_bytes = strings.bytes,
+        };
+        h.kinds_offset = NTOK_ALIGN(sizeof(NtokHeader));
+        h.spans_offset = NTOK_ALIGN(h.kinds_offset + n);
+        h.payloads_offset = NTOK_ALIGN(h.spans_offset + n * sizeof(NtokSpan));
+        h.strings_offset = NTOK_ALIGN(h.payloads_offset + n * sizeof(NtokPayload));
+        h.string_data_offset = NTOK_ALIGN(h.strings_offset + strings.count * sizeof(NtokString));
+        h.file_size = NTOK_ALIGN(h.string_data_offset + strings.bytes);
+
+        image = calloc(1, h.file_size);
+        if (image) {
+            memcpy(image, &h, sizeof(h));
+            memcpy(image + h.kinds_offset, kinds, n);
+            memcpy(image + h.spans_offset, spans, n * sizeof(NtokSpan));
+            memcpy(image + h.payloads_offset, payloads, n * sizeof(NtokPayload));
+            if (strings.count) {
+                memcpy(image + h.strings_offset, strings.items, strings.count * sizeof(NtokString));
+                memcpy(image + h.string_data_offset, strings.data, strings.bytes);
+            }
+            *out_size = h.file_size;
+        }
+    }
+
+    if (kinds && spans && payloads) ntok_strings_free(&strings);
+    free(kinds);
+    free(spans);
+    free(payloads);
+    return image;
+}
+
+// 写临时文件后rename，读者不会看到半写的缓存
+static int ntok_write_image(const char* path, const void* image, size_t size) {
+    size_t plen = strlen(path);
+    char* tmp = malloc(plen + 32);
+    if (!tmp) return -1;
+    snprintf(tmp, plen + 32, "%s.tmp.%ld", path, (long)getpid());
+
+    int rc = -1;
+    FILE* f = fopen(tmp, "wb");
+    if (f) {
+        bool w = fwrite(image, 1, size, f) == size;
+        w = (fclose(f) == 0) && w;
+        if (w && rename(tmp, path) == 0) {
+            rc = 0;
+        } else {
+            unlink(tmp);
+        }
+    }
+    free(tmp);
+    return rc;
+}
+
+int ntok_write(const char* path, const char* src, size_t len, const TokenStream* stream) {
+    size_t size = 0;
+    void* image = ntok_build(src, len, stream, &size);
+    if (!image) return -1;
+    int rc = ntok_write_image(path, image, size);
+    free(image);
+    return rc;
+}
+
+
+// ============================================================================
+// 读取
+// ============================================================================
+// 区间[offset, offset+size)须落在文件内（防溢出）
+static bool ntok_in_bounds(uint64_t offset, uint64_t count, uint64_t elem, uint64_t file_size) {
+    if (offset > file_size || (offset & 7)) return false;
+    if (elem && count > (file_size - offset) / elem) return false;
+    return true;
+}
+
+// 视图各指针指向映像（mmap区域或未能落盘的堆内存）内的对应区段
+static void ntok_view_bind(NtokView* view, void* image, size_t size, bool mapped) {
+    const NtokHeader* h = image;
+    const char* base = image;
+    *view = (NtokView){
+        .header = h,
+        .kinds = (const uint8_t*)(base + h->kinds_offset),
+        .spans = (const NtokSpan*)(base + h->spans_offset),
+        .payloads = (const NtokPayload*)(base + h->payloads_offset),
+        .strings = (const NtokString*)(base + h->strings_offset),
+        .string_data = base + h->string_data_offset,
+        .count = h->token_count,
+        .map = image,
+        .map_size = size,
+        .mapped = mapped,
+    };
+}
+
+// 原位访问不再检查下标：打开时一次遍历校验Token种类、字符串索引与字符串区间
+static bool ntok_validate(const NtokView* view) {
+    const NtokHeader* h = view->header;
+    for (uint32_t s = 0; s < h->string_count; ++s) {
+        const NtokString* e = &view->strings[s];
+        if (e->offset >= h->string_bytes || e->len >= h->string_bytes - e->offset) return false;
+        if (view->string_data[e->offset + e->len] != '\0') return false;
+    }
+    for (size_t i = 0; i < view->count; ++i) {
+        const NtokPayload* p = &view->payloads[i];
+        if (view->kinds[i] >= NTOK_KIND_COUNT) return false;
+        if (p->text != NTOK_NO_STRING && p->text >= h->string_count) return false;
+        if (view->kinds[i] == Tk_Literal && p->aux != NTOK_NO_STRING && p->aux >= h->string_count) return false;
+        if ((uint64_t)view->spans[i].start + view->spans[i].len > h->source_len) return false;
+    }
+    return true;
+}
+
+int ntok_open(const char* path, const char* src, size_t len, NtokView* view) {
+    memset(view, 0, sizeof(*view));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(NtokHeader)) {
+        close(fd);
+        return -1;
+    }
+    size_t size = (size_t)st.st_size;
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    const NtokHeader* h = map;
+    bool ok = h->magic == NTOK_MAGIC &&
+              h->version == NTOK_VERSION &&
+              h->kind_count == NTOK_KIND_COUNT &&
+              h->file_size == size &&
+              h->source_len == len &&
+              ntok_in_bounds(h->kinds_offset, h->token_count, 1, size) &&
+              ntok_in_bounds(h->spans_offset, h->token_count, sizeof(NtokSpan), size) &&
+              ntok_in_bounds(h->payloads_offset, h->token_count, sizeof(NtokPayload), size) &&
+              ntok_in_bounds(h->strings_offset, h->string_count, sizeof(NtokString), size) &&
+              ntok_in_bounds(h->string_data_offset, h->string_bytes, 1, size) &&
+              h->content_hash == ntok_content_hash(src, len);
+    if (!ok) {
+        munmap(map, size);
+        return -1;
+    }
+
+    ntok_view_bind(view, map, size, true);
+    if (!ntok_validate(view)) {
+        ntok_close(view);
+        return -1;
+    }
+    return 0;
+}
+
+void ntok_close(NtokView* view) {
+    if (view->map) {
+        if (view->mapped) {
+            munmap(view->map, view->map_size);
+        } else {
+            free(view->map);
+        }
+    }
+    memset(view, 0, sizeof(*view));
+}
+
+int ntok_load_or_lex(const char* path, const char* src, size_t len, NtokView* view) {
+    if (ntok_open(path, src, len, view) == 0) return 1;
+
+    TokenStream stream;
+    lexer_tokenize(src, len, &stream);
+    size_t size = 0;
+    void* image = ntok_build(src, len, &stream, &size);
+    token_stream_free(&stream);
+    if (!image) return -1;
+
+    // 视图直接使用刚生成的映像；缓存写不进去（目录只读、磁盘满）不影响本次分析
+    int rc = ntok_write_image(path, image, size) == 0 ? 0 : 2;
+    ntok_view_bind(view, image, size, false);
+    return rc;
+}
@@ -0,0 +1,160 @@
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+#include "lexer/ring.h"
+
+
+#define RING_SPIN_LIMIT     64      // 让出CPU前的自旋次数
+
+static inline void ring_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// 先短暂自旋，之后让出CPU（核数少于线程数时避免空转整个时间片）
+static inline void ring_wait(unsigned* spins) {
+    if (++*spins < RING_SPIN_LIMIT) {
+        ring_cpu_relax();
+    } else {
+        sched_yield();
+    }
+}
+
+
+// ============================================================================
+// SPSC环
+// ============================================================================
+int token_ring_init(TokenRing* ring, size_t capacity) {
+    memset(ring, 0, sizeof(*ring));
+    size_t cap = 2 * TOKEN_RING_BATCH;
+    while (cap < capacity) cap <<= 1;
+    ring->slots = calloc(cap, sizeof(Token*));
+    if (!ring->slots) return -1;
+    ring->mask = cap - 1;
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->closed, false);
+    return 0;
+}
+
+void token_ring_destroy(TokenRing* ring) {
+    if (!ring->slots) return;
+    // 须在生产者关闭后调用
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    for (size_t i = ring->head_local; i < tail; ++i) {
+        token_free(ring->slots[i & ring->mask]);
+    }
+    free(ring->slots);
+    ring->slots = NULL;
+}
+
+void token_ring_flush(TokenRing* ring) {
+    atomic_store_explicit(&ring->tail, ring->tail_local, memory_order_release);
+}
+
+void token_ring_push(TokenRing* ring, Token* token) {
+    size_t cap = ring->mask + 1;
+    if (ring->tail_local - ring->head_cache == cap) {
+        ring->head_cache = atomic_load_explicit(&ring->head, memory_order_acquire);
+        unsigned spins = 0;
+        while (ring->tail_local - ring->head_cache == cap) {
+            token_ring_flush(ring);     // 满时先发布，消费者才能继续
+            ring_wait(&spins);
+            ring->head_cache = atomic_load_explicit(&ring->head, memory_order_acquire);
+        }
+    }
+    ring->slots[ring->tail_local & ring->mask] = token;
+    ring->tail_local++;
+    if ((ring->tail_local & (TOKEN_RING_BATCH - 1)) == 0) token_ring_flush(ring);
+}
+
+void token_ring_close(TokenRing* ring) {
+    token_ring_flush(ring);
+    atomic_store_explicit(&ring->closed, true, memory_order_release);
+}
+
+// 确保至少有n个可读Token；已关闭且不足时返回false
+static bool token_ring_wait_for(TokenRing* ring, size_t n) {
+    if (ring->tail_cache - ring->head_local >= n) return true;
+    ring->tail_cache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (ring->tail_cache - ring->head_local >= n) return true;
+
+    // 等待前发布读位置，避免生产者因环满而与本线程互等
+    atomic_store_explicit(&ring->head, ring->head_local, memory_order_release);
+    unsigned spins = 0;
+    for (;;) {
+        bool closed = atomic_load_explicit(&ring->closed, memory_order_acquire);
+        ring->tail_cache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (ring->tail_cache - ring->head_local >= n) return true;
+        if (closed) return false;       // 关闭前的最后一次发布已在上面读到
+        ring_wait(&spins);
+    }
+}
+
+Token* token_ring_pop(TokenRing* ring) {
+    if (!token_ring_wait_for(ring, 1)) return NULL;
+    Token* token = ring->slots[ring->head_local & ring->mask];
+    ring->head_local++;
+    if ((ring->head_local & (TOKEN_RING_BATCH - 1)) == 0) {
+        atomic_store_explicit(&ring->head, ring->head_local, memory_order_release);
+    }
+    return token;
+}
+
+Token* token_ring_peek(TokenRing* ring, size_t k) {
+    if (k > ring->mask || !token_ring_wait_for(ring, k + 1)) return NULL;
+    return ring->slots[(ring->head_local + k) & ring->mask];
+}
+
+
+// ============================================================================
+// 词法/语法流水线
+// ============================================================================
+static void* token_pipe_thread(void* arg) {
+    TokenPipe* pipe = arg;
+    Token* token;
+    while ((token = lexer_next(&pipe->lexer))) {
+        token_ring_push(&pipe->ring, token);
+    }
+    Token* eof = create_eof((Span){.lo = pipe->lexer.base + (uint32_t)pipe->lexer.len, .len = 0});
+    if (eof) token_ring_push(&pipe->ring, eof);
+    token_ring_close(&pipe->ring);
+    return NULL;
+}
+
+int token_pipe_start(TokenPipe* pipe, const char* src, size_t len, size_t capacity) {
+    memset(pipe, 0, sizeof(*pipe));
+    if (token_ring_init(&pipe->ring, capacity ? capacity : TOKEN_RING_DEFAULT) != 0) return -1;
+    lexer_init(&pipe->lexer, src, len);
+    if (pthread_create(&pipe->thread, NULL, token_pipe_thread, pipe) != 0) {
+        token_ring_destroy(&pipe->ring);
+        return -1;
+    }
+    pipe->started = true;
+    return 0;
+}
+
+Token* next_token(TokenPipe* pipe) {
+    return token_ring_pop(&pipe->ring);
+}
+
+Token* peek_token(TokenPipe* pipe, size_t k) {
+    return token_ring_peek(&pipe->ring, k);
+}
+
+size_t token_pipe_finish(TokenPipe* pipe) {
+    if (!pipe->started) return 0;
+    // 消费者提前放弃时继续取出，让生产者不会阻塞在满环上
+    while (!atomic_load_explicit(&pipe->ring.closed, memory_order_acquire)) {
+        Token* token = token_ring_pop(&pipe->ring);
+        if (token) token_free(token);
+    }
+    pthread_join(pipe->thread, NULL);
+    token_ring_destroy(&pipe->ring);
+    pipe->started = false;
+    return pipe->lexer.errors;
+}
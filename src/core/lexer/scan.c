@@ -0,0 +1,223 @@
+#include <string.h>
+
+#if defined(__AVX512BW__) || defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#define SCAN_VECTOR     1
+#else
+#define SCAN_VECTOR     0       // 无向量指令时逐字节扫描比逐位拼掩码更快
+#endif
+
+#include "lexer/scan.h"
+
+
+// ============================================================================
+// 64字节块 -> 字符位掩码
+// ============================================================================
+typedef struct ScanChunk {
+#if defined(__AVX512BW__)
+    __m512i v;
+#elif defined(__AVX2__)
+    __m256i v[2];
+#elif defined(__SSE2__)
+    __m128i v[4];
+#else
+    const unsigned char* p;
+#endif
+} ScanChunk;
+
+// 不足一块时拷贝到补零缓冲区（0不是任何被查找的字符）
+static inline void scan_load(ScanChunk* chunk, const char* src, size_t avail, unsigned char* pad) {
+    const char* p = src;
+    if (avail < SCAN_BLOCK) {
+        memset(pad, 0, SCAN_BLOCK);
+        memcpy(pad, src, avail);
+        p = (const char*)pad;
+    }
+#if defined(__AVX512BW__)
+    chunk->v = _mm512_loadu_si512((const void*)p);
+#elif defined(__AVX2__)
+    chunk->v[0] = _mm256_loadu_si256((const __m256i*)p);
+    chunk->v[1] = _mm256_loadu_si256((const __m256i*)(p + 32));
+#elif defined(__SSE2__)
+    for (int k = 0; k < 4; ++k) chunk->v[k] = _mm_loadu_si128((const __m128i*)(p + 16 * k));
+#else
+    chunk->p = (const unsigned char*)p;
+#endif
+}
+
+// 第i位为1表示块内第i个字节等于c
+static inline uint64_t scan_eq(const ScanChunk* chunk, char c) {
+#if defined(__AVX512BW__)
+    return _mm512_cmpeq_epi8_mask(chunk->v, _mm512_set1_epi8(c));
+#elif defined(__AVX2__)
+    const __m256i needle = _mm256_set1_epi8(c);
+    uint64_t lo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk->v[0], needle));
+    uint64_t hi = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk->v[1], needle));
+    return lo | (hi << 32);
+#elif defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi8(c);
+    uint64_t m = 0;
+    for (int k = 0; k < 4; ++k) {
+        m |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk->v[k], needle)) << (16 * k);
+    }
+    return m;
+#else
+    uint64_t m = 0;
+    for (int k = 0; k < SCAN_BLOCK; ++k) m |= (uint64_t)(chunk->p[k] == (unsigned char)c) << k;
+    return m;
+#endif
+}
+
+// 被转义字符的掩码：奇数长度`\`序列之后的字符被转义，偶数长度则不影响。
+// prev_escaped携带上一块末尾未配对的`\`（即本块首字节被转义）
+static inline uint64_t scan_escaped(uint64_t backslash, uint64_t* prev_escaped) {
+    const uint64_t even_bits = 0x5555555555555555ULL;
+    backslash &= ~*prev_escaped;                            // 被转义的`\`不再开启新序列
+    uint64_t follows_escape = backslash << 1 | *prev_escaped;
+    uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+    uint64_t even_carry;
+    *prev_escaped = __builtin_add_overflow(odd_starts, backslash, &even_carry);
+    uint64_t invert = even_carry << 1;                      // 序列结束位置的奇偶翻转
+    return (even_bits ^ invert) & follows_escape;
+}
+
+
+// ============================================================================
+// 字符串扫描
+// ============================================================================
+size_t scan_quoted(const char* src, size_t len, size_t p, bool* has_escape) {
+#if !SCAN_VECTOR
+    *has_escape = false;
+    while (p < len) {
+        if (src[p] == '\\') {
+            *has_escape = true;
+            p += 2;
+            continue;
+        }
+        if (src[p] == '"') return p;
+        p++;
+    }
+    return len;
+#endif
+    unsigned char pad[SCAN_BLOCK];
+    uint64_t prev_escaped = 0;
+    bool escape = false;
+    for (size_t i = p; i < len; i += SCAN_BLOCK) {
+        ScanChunk chunk;
+        scan_load(&chunk, src + i, len - i, pad);
+        uint64_t backslash = scan_eq(&chunk, '\\');
+        uint64_t quote = scan_eq(&chunk, '"') & ~scan_escaped(backslash, &prev_escaped);
+        if (quote) {
+            uint64_t before = (quote & -quote) - 1;
+            *has_escape = escape || (backslash & before) != 0;
+            return i + (size_t)__builtin_ctzll(quote);
+        }
+        escape |= backslash != 0;
+    }
+    *has_escape = escape;
+    return len;
+}
+
+size_t scan_raw_close(const char* src, size_t len, size_t p, size_t hashes) {
+#if !SCAN_VECTOR
+    for (; p < len; p++) {
+        if (src[p] != '"') continue;
+        size_t h = 0;
+        while (h < hashes && p + 1 + h < len && src[p + 1 + h] == '#') h++;
+        if (h == hashes) return p;
+    }
+    return len;
+#endif
+    unsigned char pad[SCAN_BLOCK];
+    for (size_t i = p; i < len; i += SCAN_BLOCK) {
+        ScanChunk chunk;
+        scan_load(&chunk, src + i, len - i, pad);
+        uint64_t quote = scan_eq(&chunk, '"');
+        if (!quote) continue;
+        if (hashes == 0) return i + (size_t)__builtin_ctzll(quote);
+
+        uint64_t hash = scan_eq(&chunk, '#');
+        while (quote) {
+            size_t k = (size_t)__builtin_ctzll(quote);
+            quote &= quote - 1;
+            if (k + hashes < SCAN_BLOCK) {
+                // `#`串完整落在本块内：直接用掩码校验
+                uint64_t need = ((1ULL << hashes) - 1) << (k + 1);
+                if ((hash & need) == need) return i + k;
+            } else {
+                size_t q = i + k + 1;
+                size_t h = 0;
+                while (h < hashes && q + h < len && src[q + h] == '#') h++;
+                if (h == hashes) return i + k;
+            }
+        }
+    }
+    return len;
+}
+
+
+// ============================================================================
+// 注释扫描
+// ============================================================================
+size_t scan_line_end(const char* src, size_t len, size_t p) {
+#if !SCAN_VECTOR
+    const char* nl = memchr(src + p, '\n', len - p);
+    return nl ? (size_t)(nl - src) : len;
+#endif
+    unsigned char pad[SCAN_BLOCK];
+    for (size_t i = p; i < len; i += SCAN_BLOCK) {
+        ScanChunk chunk;
+        scan_load(&chunk, src + i, len - i, pad);
+        uint64_t nl = scan_eq(&chunk, '\n');
+        if (nl) return i + (size_t)__builtin_ctzll(nl);
+    }
+    return len;
+}
+
+// 以块为单位找出全部`/*`与`*/`起点，按位置顺序调整嵌套深度。
+// 与逐字节扫描等价：一次匹配消耗两个字节，紧邻其后的重叠匹配（如`/*/`中的`*/`）被跳过
+size_t scan_block_comment(const char* src, size_t len, size_t p) {
+    size_t depth = 1;
+#if !SCAN_VECTOR
+    while (p + 1 < len) {
+        if (src[p] == '/' && src[p + 1] == '*') {
+            depth++;
+            p += 2;
+        } else if (src[p] == '*' && src[p + 1] == '/') {
+            if (--depth == 0) return p + 2;
+            p += 2;
+        } else {
+            p++;
+        }
+    }
+    return SIZE_MAX;
+#endif
+    unsigned char pad[SCAN_BLOCK];
+    size_t next = p;                // 下一个可开始匹配的位置
+    for (size_t i = p; i < len; i += SCAN_BLOCK) {
+        ScanChunk chunk;
+        scan_load(&chunk, src + i, len - i, pad);
+        uint64_t slash = scan_eq(&chunk, '/');
+        uint64_t star = scan_eq(&chunk, '*');
+        if (!(slash | star)) continue;
+
+        // 第63位的第二个字符位于下一块
+        uint64_t slash_next = i + SCAN_BLOCK < len && src[i + SCAN_BLOCK] == '/';
+        uint64_t star_next = i + SCAN_BLOCK < len && src[i + SCAN_BLOCK] == '*';
+        uint64_t opens = slash & (star >> 1 | star_next << 63);
+        uint64_t closes = star & (slash >> 1 | slash_next << 63);
+        uint64_t events = opens | closes;
+        while (events) {
+            size_t k = (size_t)__builtin_ctzll(events);
+            events &= events - 1;
+            if (i + k < next) continue;
+            next = i + k + 2;
+            if ((opens >> k) & 1) {
+                depth++;
+            } else if (--depth == 0) {
+                return next;
+            }
+        }
+    }
+    return SIZE_MAX;
+}
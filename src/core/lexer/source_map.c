@@ -0,0 +1,114 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "lexer/source_map.h"
+
+
+// 统计行起点：逐个memchr换行
+static bool source_file_index_lines(SourceFile* file) {
+    size_t cap = 64;
+    uint32_t* lines = malloc(cap * sizeof(uint32_t));
+    if (!lines) return false;
+    size_t count = 0;
+    lines[count++] = 0;
+
+    const char* src = file->src;
+    const char* end = src + file->len;
+    for (const char* p = src; p < end; ) {
+        const char* nl = memchr(p, '\n', (size_t)(end - p));
+        if (!nl) break;
+        if (count == cap) {
+            uint32_t* grown = realloc(lines, cap * 2 * sizeof(uint32_t));
+            if (!grown) {
+                free(lines);
+                return false;
+            }
+            lines = grown;
+            cap *= 2;
+        }
+        p = nl + 1;
+        lines[count++] = (uint32_t)(p - src);
+    }
+    file->lines = lines;
+    file->line_count = (uint32_t)count;
+    return true;
+}
+
+void source_map_init(SourceMap* map) {
+    memset(map, 0, sizeof(*map));
+}
+
+void source_map_destroy(SourceMap* map) {
+    for (uint32_t i = 0; i < map->count; ++i) {
+        free(map->files[i]->name);
+        free(map->files[i]->lines);
+        free(map->files[i]);
+    }
+    free(map->files);
+    memset(map, 0, sizeof(*map));
+}
+
+const SourceFile* source_map_add(SourceMap* map, const char* name, const char* src, size_t len) {
+    // 区间[base, base+len]，其后空出一个字节
+    if (len >= (size_t)SOURCE_MAP_MAX - map->next_base) return NULL;
+    if (map->count == map->capacity) {
+        uint32_t cap = map->capacity ? map->capacity * 2 : 8;
+        SourceFile** grown = realloc(map->files, cap * sizeof(SourceFile*));
+        if (!grown) return NULL;
+        map->files = grown;
+        map->capacity = cap;
+    }
+
+    SourceFile* file = calloc(1, sizeof(SourceFile));
+    if (!file) return NULL;
+    file->name = strdup(name ? name : "");
+    file->src = src;
+    file->base = map->next_base;
+    file->len = (uint32_t)len;
+    if (!file->name || !source_file_index_lines(file)) {
+        free(file->name);
+        free(file);
+        return NULL;
+    }
+
+    map->files[map->count++] = file;
+    map->next_base += (uint32_t)len + 1;
+    return file;
+}
+
+const SourceFile* source_map_file(const SourceMap* map, uint32_t pos) {
+    // 最后一个base <= pos的文件
+    uint32_t lo = 0, hi = map->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (map->files[mid]->base <= pos) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) return NULL;
+    const SourceFile* file = map->files[lo - 1];
+    return pos - file->base <= file->len ? file : NULL;
+}
+
+bool source_map_lookup(const SourceMap* map, uint32_t pos, SourceLoc* loc) {
+    const SourceFile* file = source_map_file(map, pos);
+    if (!file) return false;
+
+    // 最后一个起点 <= off的行
+    uint32_t off = pos - file->base;
+    uint32_t lo = 0, hi = file->line_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (file->lines[mid] <= off) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    loc->file = file;
+    loc->line = lo;
+    loc->column = off - file->lines[lo - 1] + 1;
+    return true;
+}
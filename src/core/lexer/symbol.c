@@ -1,14 +1,50 @@
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
 #include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
+#include "lexer/hash.h"
 #include "lexer/symbol.h"
 
 
+#define SYMTAB_INIT_BUCKETS     64
+#define SYMTAB_NOT_FOUND        UINT32_MAX
+
+// 快照文件：头部 | entries[count] | ctrl[buckets] | slots[buckets] | 字符串区，各段按64字节对齐；
+//  按本机字节序写出，以endian字段拒绝不同字节序的文件
+#define SYMTAB_SNAPSHOT_MAGIC   0x314241544d59534eULL   // "NSYMTAB1"
+#define SYMTAB_SNAPSHOT_VERSION 1
+#define SYMTAB_SNAPSHOT_ENDIAN  0x01020304U
+#define SYMTAB_SNAPSHOT_ALIGN   64
+
+typedef struct SymbolSnapshotHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t endian;
+    uint64_t seed;              // HASH64_SEED：哈希随种子变化，种子不同的快照不可用
+    uint32_t count;             // 符号数（ID [0, count)）
+    uint32_t predefined;        // SYM_COUNT
+    uint64_t buckets;
+    uint64_t entries_off;
+    uint64_t ctrl_off;
+    uint64_t slots_off;
+    uint64_t strings_off;
+    uint64_t strings_size;
+    uint64_t file_size;
+} SymbolSnapshotHeader;
+
+
 // 预定义符号字符串数组
 static const char* predefined_strs[] = {
-    #define SYM(id, str) [SYM_##id] = str,
+    #define SYM(id, str, hash) [SYM_##id] = str,
     // #define SYMBOL_LIST
     #include "lexer/symbol_defs.h"
     SYMBOL_LIST
@@ -16,120 +52,813 @@ static const char* predefined_strs[] = {
     #undef SYM
 };
 
+// 预定义符号哈希（symbol_defs.h中预先算好）
+static const uint64_t predefined_hashes[] = {
+    #define SYM(id, str, hash) [SYM_##id] = hash,
+    #include "lexer/symbol_defs.h"
+    SYMBOL_LIST
+    #undef SYMBOL_LIST
+    #undef SYM
+};
+
 
 // 全局符号表实例
 static SymbolTable global_symtab = {0};
+static atomic_bool global_symtab_ready = false;
+static pthread_mutex_t global_symtab_init_lock = PTHREAD_MUTEX_INITIALIZER;
+// 每次cleanup递增，线程本地缓存据此丢弃指向旧字符串区的条目
+static _Atomic uint32_t global_symtab_epoch = 0;
+
+// 线程本地缓存：str指向字符串区，符号表销毁前始终有效
+typedef struct SymbolCacheEntry {
+    const char* str;
+    uint32_t hash;          // 完整哈希的低32位
+    uint32_t len;
+    Symbol sym;
+} SymbolCacheEntry;
 
+typedef struct SymbolCache {
+    SymbolCacheEntry slots[SYMBOL_CACHE_SIZE];
+    SymbolCacheStats stats;
+    uint32_t epoch;
+} SymbolCache;
 
-// FNV-1a哈希算法
-static uint32_t fnv1a_hash(const char* str, size_t len) {
-    const uint32_t FNV_PRIME = 16777619U;
-    uint32_t hash = 2166136261U;
-    for (size_t i = 0; i < len; ++i) {
-        hash ^= (uint8_t)str[i];
-        hash *= FNV_PRIME;
+// 缓存约100KB，首次内部化时才在堆上分配，未做内部化的线程只占一个指针的静态TLS；
+//  线程退出时经symbol_cache_key的析构释放
+static __thread SymbolCache* symbol_cache = NULL;
+static pthread_key_t symbol_cache_key;
+static pthread_once_t symbol_cache_key_once = PTHREAD_ONCE_INIT;
+
+
+// ============================================================================
+// 分段条目存储
+//  第k段存放ID [SEG0*(2^k-1), SEG0*(2^(k+1)-1))，段指针一经发布不再改变
+// ============================================================================
+static inline uint32_t symtab_segment_of(uint32_t id, uint32_t* offset) {
+    uint32_t k = 31 - (uint32_t)__builtin_clz((id >> SYMTAB_SEG0_BITS) + 1);
+    *offset = id - (((1U << k) - 1) << SYMTAB_SEG0_BITS);
+    return k;
+}
+
+// 读者路径：段未分配时返回NULL
+static inline SymbolEntry* symtab_entry(SymbolTable* tab, uint32_t id) {
+    uint32_t offset;
+    uint32_t k = symtab_segment_of(id, &offset);
+    SymbolEntry* seg = atomic_load_explicit(&tab->segments[k], memory_order_acquire);
+    return seg ? &seg[offset] : NULL;
+}
+
+// 写者路径：按需分配段，并发分配时以CAS胜者为准
+static SymbolEntry* symtab_entry_alloc(SymbolTable* tab, uint32_t id) {
+    uint32_t offset;
+    uint32_t k = symtab_segment_of(id, &offset);
+    if (k >= SYMTAB_SEGMENTS) return NULL;
+    SymbolEntry* seg = atomic_load_explicit(&tab->segments[k], memory_order_acquire);
+    if (!seg) {
+        SymbolEntry* fresh = calloc((size_t)SYMTAB_SEG0 << k, sizeof(SymbolEntry));
+        if (!fresh) return NULL;
+        if (atomic_compare_exchange_strong_explicit(&tab->segments[k], &seg, fresh,
+                memory_order_acq_rel, memory_order_acquire)) {
+            seg = fresh;
+        } else {
+            free(fresh);
+        }
     }
-    return hash;
+    return &seg[offset];
 }
 
-void symbol_table_init(void) {
-    pthread_mutex_init(&global_symtab.lock, NULL);
-    
-    // 初始化预定义符号
-    global_symtab.capacity = SYM_COUNT * 2;
-    global_symtab.entries = calloc(global_symtab.capacity, sizeof(SymbolEntry));
-    
+
+// ============================================================================
+// 分片哈希索引
+//  哈希位划分：低7位为控制字节，其上SYMTAB_SHARD_BITS位选择分片，高32位选择起始组
+// ============================================================================
+// 组内等于byte的槽位掩码（bit i对应ctrl[i]）
+static inline uint32_t symtab_group_match(const uint8_t* ctrl, uint8_t byte) {
+#if defined(__SSE2__)
+    __m128i group = _mm_load_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)byte)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < SYMTAB_GROUP; ++i) {
+        mask |= (uint32_t)(ctrl[i] == byte) << i;
+    }
+    return mask;
+#endif
+}
+
+static inline uint8_t symtab_h2(uint64_t hash) {
+    return (uint8_t)(hash & 0x7F);
+}
+
+static inline SymbolShard* symtab_shard(SymbolTable* tab, uint64_t hash) {
+    return &tab->shards[(hash >> 7) & (SYMTAB_SHARDS - 1)];
+}
+
+// 起始组由哈希高32位决定（与控制字节、分片位互不重叠），之后按三角数跳组（组数为2的幂时遍历全部组）
+static inline size_t symtab_first_group(uint64_t hash, size_t group_mask) {
+    return (size_t)(hash >> 32) & group_mask;
+}
+
+// 查找键：短键预先复制为与条目相同的零填充形式，比较时只做定长比较
+typedef struct SymbolKey {
+    const char* str;
+    uint64_t hash;
+    uint32_t len;
+    char packed[SYMBOL_INLINE_SIZE];    // 短键的零填充副本；长键只用前4字节
+} SymbolKey;
+
+static inline void symtab_key_init(SymbolKey* key, const char* str, uint32_t len, uint64_t hash) {
+    key->str = str;
+    key->hash = hash;
+    key->len = len;
+    memset(key->packed, 0, SYMBOL_INLINE_SIZE);
+    memcpy(key->packed, str, len <= SYMBOL_INLINE_MAX ? len : sizeof(((SymbolEntry*)0)->data.ext.prefix));
+}
+
+static inline bool symtab_entry_equals(const SymbolEntry* entry, const SymbolKey* key) {
+    if (entry->hash != key->hash || entry->len != key->len) return false;
+    if (key->len <= SYMBOL_INLINE_MAX) {
+        return memcmp(entry->data.str, key->packed, SYMBOL_INLINE_SIZE) == 0;
+    }
+    return memcmp(entry->data.ext.prefix, key->packed, sizeof(entry->data.ext.prefix)) == 0 &&
+           memcmp(entry->data.ext.ptr, key->str, key->len) == 0;
+}
+
+static inline const char* symtab_entry_str(const SymbolEntry* entry) {
+    return entry->len <= SYMBOL_INLINE_MAX ? entry->data.str : entry->data.ext.ptr;
+}
+
+// 写入条目内容；长字符串的副本ext由调用者在字符串区分配
+static void symtab_entry_fill(SymbolEntry* entry, const SymbolKey* key, const char* ext) {
+    entry->hash = key->hash;
+    entry->len = key->len;
+    if (key->len <= SYMBOL_INLINE_MAX) {
+        memcpy(entry->data.str, key->packed, SYMBOL_INLINE_SIZE);
+    } else {
+        memcpy(entry->data.ext.prefix, key->packed, sizeof(entry->data.ext.prefix));
+        entry->data.ext.ptr = ext;
+    }
+}
+
+// 在索引中查找已有条目；未找到时返回SYMTAB_NOT_FOUND，并在insert_at给出插入槽位。
+//  不持锁调用时，控制字节命中后的acquire栅栏与写者的release写配对，保证看到完整的slots与条目
+static uint32_t symtab_find(SymbolTable* tab, const SymbolIndex* index,
+        const SymbolKey* key, size_t* insert_at) {
+    const size_t group_mask = index->buckets / SYMTAB_GROUP - 1;
+    const uint8_t h2 = symtab_h2(key->hash);
+    size_t g = symtab_first_group(key->hash, group_mask);
+    for (size_t step = 1; ; ++step) {
+        const size_t base = g * SYMTAB_GROUP;
+        const uint8_t* ctrl = index->ctrl + base;
+        uint32_t m = symtab_group_match(ctrl, h2);
+        if (m) atomic_thread_fence(memory_order_acquire);
+        for (; m; m &= m - 1) {
+            uint32_t id = index->slots[base + (size_t)__builtin_ctz(m)];
+            if (symtab_entry_equals(symtab_entry(tab, id), key)) return id;
+        }
+        // 不删除槽位：组内出现空槽即说明探测序列到此为止
+        uint32_t empty = symtab_group_match(ctrl, SYMTAB_CTRL_EMPTY);
+        if (empty) {
+            if (insert_at) *insert_at = base + (size_t)__builtin_ctz(empty);
+            return SYMTAB_NOT_FOUND;
+        }
+        g = (g + step) & group_mask;
+    }
+}
+
+// 仅按哈希找空槽（重建索引时使用）
+static size_t symtab_probe_empty(const SymbolIndex* index, uint64_t hash) {
+    const size_t group_mask = index->buckets / SYMTAB_GROUP - 1;
+    size_t g = symtab_first_group(hash, group_mask);
+    for (size_t step = 1; ; ++step) {
+        uint32_t empty = symtab_group_match(index->ctrl + g * SYMTAB_GROUP, SYMTAB_CTRL_EMPTY);
+        if (empty) return g * SYMTAB_GROUP + (size_t)__builtin_ctz(empty);
+        g = (g + step) & group_mask;
+    }
+}
+
+// 基础层查找：索引只读，无需加锁。控制字节来自文件且加载时不逐一校验，
+// 探测至多走遍每组一次（三角探测在2的幂组数下恰好覆盖全部组），没有空槽也会结束
+static uint32_t symtab_base_find(const SymbolSnapshot* base, const SymbolKey* key) {
+    const size_t group_mask = base->buckets / SYMTAB_GROUP - 1;
+    const uint8_t h2 = symtab_h2(key->hash);
+    size_t g = symtab_first_group(key->hash, group_mask);
+    for (size_t step = 1; step <= group_mask + 1; ++step) {
+        const size_t at = g * SYMTAB_GROUP;
+        const uint8_t* ctrl = base->ctrl + at;
+        for (uint32_t m = symtab_group_match(ctrl, h2); m; m &= m - 1) {
+            uint32_t id = base->slots[at + (size_t)__builtin_ctz(m)];
+            if (id >= base->count) continue;
+            const SymbolSnapshotEntry* entry = &base->entries[id];
+            if (entry->hash == key->hash && entry->len == key->len &&
+                memcmp(base->strings + entry->str, key->str, key->len) == 0) {
+                return id;
+            }
+        }
+        if (symtab_group_match(ctrl, SYMTAB_CTRL_EMPTY)) return SYMTAB_NOT_FOUND;
+        g = (g + step) & group_mask;
+    }
+    return SYMTAB_NOT_FOUND;
+}
+
+// 控制字节最后写入：读者看到它时slots与条目均已可见
+static void symtab_place(SymbolIndex* index, size_t slot, uint32_t id, uint64_t hash) {
+    index->slots[slot] = id;
+    __atomic_store_n(&index->ctrl[slot], symtab_h2(hash), __ATOMIC_RELEASE);
+    index->used++;
+}
+
+static SymbolIndex* symtab_index_new(size_t buckets) {
+    SymbolIndex* index = malloc(sizeof(SymbolIndex));
+    uint8_t* ctrl = aligned_alloc(SYMTAB_GROUP, buckets);
+    uint32_t* slots = malloc(buckets * sizeof(uint32_t));
+    if (!index || !ctrl || !slots) {
+        free(index);
+        free(ctrl);
+        free(slots);
+        return NULL;
+    }
+    memset(ctrl, SYMTAB_CTRL_EMPTY, buckets);
+    *index = (SymbolIndex){ .ctrl = ctrl, .slots = slots, .buckets = buckets };
+    return index;
+}
+
+static void symtab_index_free(SymbolIndex* index) {
+    while (index) {
+        SymbolIndex* retired = index->retired;
+        free(index->ctrl);
+        free(index->slots);
+        free(index);
+        index = retired;
+    }
+}
+
+// 按条目中保存的哈希建更大的索引并发布（须持有分片锁），无需重新哈希字符串；
+//  旧索引保留给仍在其上查找的读者
+static SymbolIndex* symtab_grow(SymbolTable* tab, SymbolShard* shard) {
+    SymbolIndex* old = atomic_load_explicit(&shard->index, memory_order_relaxed);
+    SymbolIndex* index = symtab_index_new(old->buckets * 2);
+    if (!index) return NULL;
+    for (size_t i = 0; i < old->buckets; ++i) {
+        if (old->ctrl[i] == SYMTAB_CTRL_EMPTY) continue;
+        uint64_t hash = symtab_entry(tab, old->slots[i])->hash;
+        symtab_place(index, symtab_probe_empty(index, hash), old->slots[i], hash);
+    }
+    index->retired = old;
+    atomic_store_explicit(&shard->index, index, memory_order_release);
+    return index;
+}
+
+
+// ============================================================================
+// 字符串区
+//  每个分片一条块链，在分片锁内分配，无需额外同步；超过块大小四分之一的
+//  字符串单独成块，挂在当前块之后，避免浪费当前块的剩余空间
+// ============================================================================
+static SymbolArenaChunk* symtab_arena_chunk(size_t size) {
+    SymbolArenaChunk* chunk = malloc(sizeof(SymbolArenaChunk) + size);
+    if (!chunk) return NULL;
+    chunk->next = NULL;
+    chunk->size = size;
+    return chunk;
+}
+
+// 复制str并追加'\0'（须持有分片锁）
+static const char* symtab_arena_copy(SymbolShard* shard, const char* str, size_t len) {
+    size_t need = len + 1;
+    char* dst;
+    if (need > SYMTAB_ARENA_CHUNK / 4) {
+        SymbolArenaChunk* big = symtab_arena_chunk(need);
+        if (!big) return NULL;
+        if (shard->arena) {
+            big->next = shard->arena->next;
+            shard->arena->next = big;
+        } else {
+            shard->arena = big;
+            shard->arena_used = need;
+        }
+        dst = big->data;
+    } else {
+        if (!shard->arena || shard->arena_used + need > shard->arena->size) {
+            SymbolArenaChunk* chunk = symtab_arena_chunk(SYMTAB_ARENA_CHUNK);
+            if (!chunk) return NULL;
+            chunk->next = shard->arena;
+            shard->arena = chunk;
+            shard->arena_used = 0;
+        }
+        dst = shard->arena->data + shard->arena_used;
+        shard->arena_used += need;
+    }
+    memcpy(dst, str, len);
+    dst[len] = '\0';
+    return dst;
+}
+
+
+// ============================================================================
+// 符号表接口
+// ============================================================================
+static void symbol_table_build(void) {
+    for (uint32_t i = 0; i < SYMTAB_SHARDS; ++i) {
+        SymbolShard* shard = &global_symtab.shards[i];
+        pthread_mutex_init(&shard->lock, NULL);
+        atomic_init(&shard->index, symtab_index_new(SYMTAB_INIT_BUCKETS));
+    }
+
+    // 基础层已包含预定义符号（ID相同），新符号从其后编号
+    if (global_symtab.base.map) {
+        atomic_store_explicit(&global_symtab.size, global_symtab.base.count, memory_order_release);
+        return;
+    }
+
+    // 预定义符号占据前SYM_COUNT个ID（空串不经过索引）
     for (PredefinedSymbols id = 0; id < SYM_COUNT; ++id) {
         const char* str = predefined_strs[id];
-        size_t len = strlen(str);
-        uint32_t hash = fnv1a_hash(str, len);
-        
-        SymbolEntry entry = {
-            .str = str,
-            .len = len,
-            .hash = hash,
-            .refcount = 1
-        };
-        
-        // 直接插入预定义位置
-        global_symtab.entries[id] = entry;
-    }
-    global_symtab.size = SYM_COUNT;
+        uint32_t len = (uint32_t)strlen(str);
+        uint64_t hash = predefined_hashes[id];
+        SymbolKey key;
+        symtab_key_init(&key, str, len, hash);
+        symtab_entry_fill(symtab_entry_alloc(&global_symtab, id), &key, str);
+        if (len > 0) {
+            SymbolIndex* index = atomic_load_explicit(&symtab_shard(&global_symtab, hash)->index, memory_order_relaxed);
+            symtab_place(index, symtab_probe_empty(index, hash), id, hash);
+        }
+    }
+    atomic_store_explicit(&global_symtab.size, SYM_COUNT, memory_order_release);
+}
+
+void symbol_table_init(void) {
+    if (atomic_load_explicit(&global_symtab_ready, memory_order_acquire)) return;
+    pthread_mutex_lock(&global_symtab_init_lock);
+    if (!atomic_load_explicit(&global_symtab_ready, memory_order_relaxed)) {
+        symbol_table_build();
+        atomic_store_explicit(&global_symtab_ready, true, memory_order_release);
+    }
+    pthread_mutex_unlock(&global_symtab_init_lock);
+}
+
+void symbol_table_cleanup(void) {
+    pthread_mutex_lock(&global_symtab_init_lock);
+    if (atomic_load_explicit(&global_symtab_ready, memory_order_relaxed)) {
+        for (uint32_t i = 0; i < SYMTAB_SHARDS; ++i) {
+            SymbolShard* shard = &global_symtab.shards[i];
+            for (SymbolArenaChunk* c = shard->arena; c; ) {
+                SymbolArenaChunk* next = c->next;
+                free(c);
+                c = next;
+            }
+            symtab_index_free(atomic_load_explicit(&shard->index, memory_order_relaxed));
+            pthread_mutex_destroy(&shard->lock);
+        }
+        for (uint32_t k = 0; k < SYMTAB_SEGMENTS; ++k) {
+            free(atomic_load_explicit(&global_symtab.segments[k], memory_order_relaxed));
+        }
+        if (global_symtab.base.map) munmap(global_symtab.base.map, global_symtab.base.map_size);
+        memset(&global_symtab, 0, sizeof(global_symtab));
+        atomic_fetch_add_explicit(&global_symtab_epoch, 1, memory_order_relaxed);
+        atomic_store_explicit(&global_symtab_ready, false, memory_order_release);
+    }
+    pthread_mutex_unlock(&global_symtab_init_lock);
+}
+
+void symbol_table_stats(SymbolTableStats* stats) {
+    *stats = (SymbolTableStats){
+        .symbols = atomic_load_explicit(&global_symtab.size, memory_order_acquire),
+        .base_symbols = global_symtab.base.count,
+    };
+    for (uint32_t i = 0; i < SYMTAB_SHARDS; ++i) {
+        SymbolShard* shard = &global_symtab.shards[i];
+        pthread_mutex_lock(&shard->lock);
+        for (const SymbolArenaChunk* c = shard->arena; c; c = c->next) {
+            stats->arena_chunks++;
+            stats->arena_bytes += c == shard->arena ? shard->arena_used : c->size;
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+static inline Symbol symtab_symbol(uint32_t id) {
+    return (Symbol){id, id < SYM_COUNT ? SYM_FLAG_PREDEFINED : SYM_FLAG_INTERNED};
+}
+
+// 不加锁查找已有符号：先基础层，再分片当前索引；预定义符号与已内部化条目同在索引中
+static uint32_t symtab_lookup(const SymbolKey* key, const SymbolIndex* index) {
+    if (global_symtab.base.map) {
+        uint32_t id = symtab_base_find(&global_symtab.base, key);
+        if (id != SYMTAB_NOT_FOUND) return id;
+    }
+    return symtab_find(&global_symtab, index, key, NULL);
+}
+
+// 须持有分片锁：在当前索引上复查（其间可能已有其他线程插入或扩容），不存在则创建
+static Symbol symtab_insert_locked(SymbolShard* shard, const SymbolKey* key) {
+    SymbolIndex* index = atomic_load_explicit(&shard->index, memory_order_relaxed);
+    size_t slot = 0;
+    uint32_t found = symtab_find(&global_symtab, index, key, &slot);
+    if (found != SYMTAB_NOT_FOUND) return symtab_symbol(found);
+
+    // 负载超过7/8时分片索引翻倍，插入位置随之重新探测
+    if ((index->used + 1) * 8 > index->buckets * 7) {
+        if (!(index = symtab_grow(&global_symtab, shard))) return MACRO_SYM_EMPTY;
+        slot = symtab_probe_empty(index, key->hash);
+    }
+
+    // 创建新条目：ID全局递增，条目写入所在段后再进入索引；短字符串不占用字符串区
+    uint32_t id = atomic_fetch_add_explicit(&global_symtab.size, 1, memory_order_relaxed);
+    SymbolEntry* entry = symtab_entry_alloc(&global_symtab, id);
+    const char* copy = NULL;
+    if (entry && key->len > SYMBOL_INLINE_MAX) copy = symtab_arena_copy(shard, key->str, key->len);
+    if (!entry || (key->len > SYMBOL_INLINE_MAX && !copy)) return MACRO_SYM_EMPTY;
+    symtab_entry_fill(entry, key, copy);
+    symtab_place(index, slot, id, key->hash);
+    return (Symbol){id, SYM_FLAG_INTERNED};
+}
+
+// 全局表路径：已有符号不加锁、不写共享内存，只有创建时持分片锁
+static Symbol symtab_intern(const SymbolKey* key) {
+    SymbolShard* shard = symtab_shard(&global_symtab, key->hash);
+    uint32_t found = symtab_lookup(key, atomic_load_explicit(&shard->index, memory_order_acquire));
+    if (found != SYMTAB_NOT_FOUND) return symtab_symbol(found);
+
+    pthread_mutex_lock(&shard->lock);
+    Symbol sym = symtab_insert_locked(shard, key);
+    pthread_mutex_unlock(&shard->lock);
+    return sym;
+}
+
+static inline uint32_t symbol_cache_index(uint64_t hash, size_t len) {
+    return ((uint32_t)hash ^ ((uint32_t)len * 0x9E3779B9U)) >> (32 - SYMBOL_CACHE_BITS);
+}
+
+static void symbol_cache_release(void* cache) {
+    symbol_cache = NULL;
+    free(cache);
+}
+
+static void symbol_cache_key_init(void) {
+    pthread_key_create(&symbol_cache_key, symbol_cache_release);
+}
+
+// 取本线程缓存，首次调用时分配；符号表重建过则清空（旧条目指向已释放的字符串区）。
+//  分配失败返回NULL，调用方跳过缓存直接查表
+static SymbolCache* symbol_cache_get(void) {
+    uint32_t epoch = atomic_load_explicit(&global_symtab_epoch, memory_order_relaxed);
+    SymbolCache* cache = symbol_cache;
+    if (__builtin_expect(cache == NULL, 0)) {
+        pthread_once(&symbol_cache_key_once, symbol_cache_key_init);
+        cache = calloc(1, sizeof(SymbolCache));
+        if (!cache) return NULL;
+        cache->epoch = epoch;
+        pthread_setspecific(symbol_cache_key, cache);
+        symbol_cache = cache;
+    } else if (cache->epoch != epoch) {
+        memset(cache->slots, 0, sizeof(cache->slots));
+        cache->epoch = epoch;
+    }
+    return cache;
+}
+
+// 命中：仅访问线程本地数据与条目/字符串区中不可变的字符串
+static inline bool symbol_cache_hit(const SymbolCacheEntry* slot, const char* str, size_t len, uint64_t hash) {
+    return slot->hash == (uint32_t)hash && slot->len == len && slot->str && memcmp(slot->str, str, len) == 0;
+}
+
+static inline void symbol_cache_fill(SymbolCache* cache, Symbol sym, size_t len, uint64_t hash) {
+    if (!cache || sym.id == SYM_EMPTY) return;      // 无缓存或内存不足
+    cache->slots[symbol_cache_index(hash, len)] = (SymbolCacheEntry){
+        .str = symbol_str(sym),
+        .hash = (uint32_t)hash,
+        .len = (uint32_t)len,
+        .sym = sym,
+    };
 }
 
 Symbol symbol_intern(const char* str, size_t len) {
-    if (len == 0) return MACRO_SYM_EMPTY;
-    
-    uint32_t hash = fnv1a_hash(str, len);
-    
-    pthread_mutex_lock(&global_symtab.lock);
-    
-    // 检查预定义符号
-    for (PredefinedSymbols id = 0; id < SYM_COUNT; ++id) {
-        const SymbolEntry* entry = &global_symtab.entries[id];
-        if (entry->len == len && 
-            entry->hash == hash &&
-            memcmp(entry->str, str, len) == 0) {
-            pthread_mutex_unlock(&global_symtab.lock);
-            return (Symbol){id, SYM_FLAG_PREDEFINED};
-        }
-    }
-    
-    // 查找现有条目
-    for (size_t i = SYM_COUNT; i < global_symtab.size; ++i) {
-        SymbolEntry* entry = &global_symtab.entries[i];
-        if (entry->len == len && 
-            entry->hash == hash &&
-            memcmp(entry->str, str, len) == 0) {
-            atomic_fetch_add_explicit(&entry->refcount, 1, memory_order_relaxed);
-            pthread_mutex_unlock(&global_symtab.lock);
-            return (Symbol){i, SYM_FLAG_INTERNED};
-        }
-    }
-    
-    // 扩容检查
-    if (global_symtab.size >= global_symtab.capacity) {
-        global_symtab.capacity *= 2;
-        global_symtab.entries = realloc(global_symtab.entries, 
-            global_symtab.capacity * sizeof(SymbolEntry));
-    }
-    
-    // 创建新条目
-    SymbolEntry* entry = &global_symtab.entries[global_symtab.size];
-    entry->str = strndup(str, len);
-    entry->len = len;
-    entry->hash = hash;
-    atomic_init(&entry->refcount, 1);
-    
-    Symbol sym = {global_symtab.size++, SYM_FLAG_INTERNED};
-    pthread_mutex_unlock(&global_symtab.lock);
+    if (len == 0 || len > UINT32_MAX) return MACRO_SYM_EMPTY;
+
+    uint64_t hash = hash64(str, len, HASH64_SEED);
+    SymbolCache* cache = symbol_cache_get();
+    if (cache) {
+        const SymbolCacheEntry* slot = &cache->slots[symbol_cache_index(hash, len)];
+        if (symbol_cache_hit(slot, str, len, hash)) {
+            cache->stats.hits++;
+            return slot->sym;
+        }
+        cache->stats.misses++;
+    }
+
+    SymbolKey key;
+    symtab_key_init(&key, str, (uint32_t)len, hash);
+    Symbol sym = symtab_intern(&key);
+    symbol_cache_fill(cache, sym, len, hash);
     return sym;
 }
 
+// 批量内部化：按块处理，每块依次
+//  1) 计算全部哈希并查线程缓存；
+//  2) 为未命中者预取分片索引的起始组（控制字节与slots）；
+//  3) 不加锁查找已有符号，此时预取多已到达；
+//  4) 仍缺失者按分片排序，每个分片只加锁一次完成该块的全部插入（块内重复由锁内复查去重）
+void symbol_intern_batch(const char** strs, const size_t* lens, size_t n, Symbol* out) {
+    SymbolCache* cache = symbol_cache_get();
+    for (size_t done = 0; done < n; done += SYMBOL_BATCH_CHUNK) {
+        const size_t count = n - done < SYMBOL_BATCH_CHUNK ? n - done : SYMBOL_BATCH_CHUNK;
+        const char** chunk = strs + done;
+        Symbol* result = out + done;
+        SymbolKey keys[SYMBOL_BATCH_CHUNK];
+        SymbolIndex* indexes[SYMBOL_BATCH_CHUNK];
+        uint8_t shards[SYMBOL_BATCH_CHUNK];
+        uint8_t miss[SYMBOL_BATCH_CHUNK];
+        size_t misses = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            size_t len = lens[done + i];
+            if (len == 0 || len > UINT32_MAX) {
+                result[i] = MACRO_SYM_EMPTY;
+                continue;
+            }
+            uint64_t hash = hash64(chunk[i], len, HASH64_SEED);
+            if (cache) {
+                const SymbolCacheEntry* slot = &cache->slots[symbol_cache_index(hash, len)];
+                if (symbol_cache_hit(slot, chunk[i], len, hash)) {
+                    cache->stats.hits++;
+                    result[i] = slot->sym;
+                    continue;
+                }
+                cache->stats.misses++;
+            }
+            keys[i].str = chunk[i];
+            keys[i].hash = hash;
+            keys[i].len = (uint32_t)len;
+            miss[misses++] = (uint8_t)i;
+        }
+
+        for (size_t m = 0; m < misses; ++m) {
+            const size_t i = miss[m];
+            SymbolShard* shard = symtab_shard(&global_symtab, keys[i].hash);
+            SymbolIndex* index = atomic_load_explicit(&shard->index, memory_order_acquire);
+            size_t at = symtab_first_group(keys[i].hash, index->buckets / SYMTAB_GROUP - 1) * SYMTAB_GROUP;
+            __builtin_prefetch(index->ctrl + at);
+            __builtin_prefetch(index->slots + at);
+            indexes[i] = index;
+            shards[i] = (uint8_t)(shard - global_symtab.shards);
+        }
+
+        size_t pending = 0;
+        for (size_t m = 0; m < misses; ++m) {
+            size_t i = miss[m];
+            symtab_key_init(&keys[i], keys[i].str, keys[i].len, keys[i].hash);
+            uint32_t found = symtab_lookup(&keys[i], indexes[i]);
+            if (found != SYMTAB_NOT_FOUND) {
+                result[i] = symtab_symbol(found);
+                symbol_cache_fill(cache, result[i], keys[i].len, keys[i].hash);
+            } else {
+                miss[pending++] = (uint8_t)i;
+            }
+        }
+
+        // 按分片插入排序（至多一块），同一分片的键连续
+        for (size_t m = 1; m < pending; ++m) {
+            uint8_t i = miss[m];
+            size_t k = m;
+            for (; k > 0 && shards[miss[k - 1]] > shards[i]; --k) miss[k] = miss[k - 1];
+            miss[k] = i;
+        }
+        for (size_t m = 0; m < pending; ) {
+            const uint8_t id = shards[miss[m]];
+            SymbolShard* shard = &global_symtab.shards[id];
+            pthread_mutex_lock(&shard->lock);
+            for (; m < pending && shards[miss[m]] == id; ++m) {
+                result[miss[m]] = symtab_insert_locked(shard, &keys[miss[m]]);
+            }
+            pthread_mutex_unlock(&shard->lock);
+        }
+        for (size_t m = 0; m < pending; ++m) {
+            size_t i = miss[m];
+            symbol_cache_fill(cache, result[i], keys[i].len, keys[i].hash);
+        }
+    }
+}
+
+// 无锁：Symbol只能来自symbol_intern，条目在其返回前已写入且段不会移动
 const char* symbol_str(Symbol sym) {
     if (sym.flags & SYM_FLAG_PREDEFINED) {
         return predefined_strs[sym.id];
     }
-    if (sym.id < global_symtab.size) {
-        return global_symtab.entries[sym.id].str;
+    if (sym.id < global_symtab.base.count) {
+        return global_symtab.base.strings + global_symtab.base.entries[sym.id].str;
+    }
+    if (sym.id < atomic_load_explicit(&global_symtab.size, memory_order_acquire)) {
+        const SymbolEntry* entry = symtab_entry(&global_symtab, sym.id);
+        return entry ? symtab_entry_str(entry) : NULL;
     }
     return NULL;
 }
 
-void symbol_ref(Symbol sym) {
-    if (!(sym.flags & SYM_FLAG_INTERNED)) return;
-    
-    SymbolEntry* entry = &global_symtab.entries[sym.id];
-    atomic_fetch_add_explicit(&entry->refcount, 1, memory_order_relaxed);
+void symbol_cache_stats(SymbolCacheStats* stats) {
+    *stats = symbol_cache ? symbol_cache->stats : (SymbolCacheStats){0};
+}
+
+void symbol_cache_reset_stats(void) {
+    if (symbol_cache) symbol_cache->stats = (SymbolCacheStats){0};
+}
+
+
+// ============================================================================
+// 快照
+//  save按ID顺序写出全部符号并为其建一个不分片的只读索引；load校验头部、预定义符号与
+//  条目区间，字符串与索引页面按需换入
+// ============================================================================
+#define SYMTAB_ALIGN_UP(x)  (((x) + SYMTAB_SNAPSHOT_ALIGN - 1) & ~(uint64_t)(SYMTAB_SNAPSHOT_ALIGN - 1))
+
+static bool symtab_write(FILE* f, const void* data, size_t size, uint64_t* off) {
+    static const char zeros[SYMTAB_SNAPSHOT_ALIGN] = {0};
+    uint64_t pad = SYMTAB_ALIGN_UP(*off) - *off;
+    if (pad && fwrite(zeros, 1, pad, f) != pad) return false;
+    if (size && fwrite(data, 1, size, f) != size) return false;
+    *off += pad + size;
+    return true;
+}
+
+int symbol_table_save(const char* path) {
+    symbol_table_init();
+    const SymbolSnapshot* base = &global_symtab.base;
+    const uint32_t count = atomic_load_explicit(&global_symtab.size, memory_order_acquire);
+
+    // 条目与字符串：分配失败留下的空ID写成空串，不进入索引
+    SymbolSnapshotEntry* entries = malloc((size_t)count * sizeof(SymbolSnapshotEntry));
+    const char** strs = malloc((size_t)count * sizeof(char*));
+    if (!entries || !strs) {
+        free(entries);
+        free(strs);
+        return -1;
+    }
+    uint64_t strings_size = 0;
+    for (uint32_t id = 0; id < count; ++id) {
+        const char* str = "";
+        uint64_t hash = 0;
+        size_t len = 0;
+        if (id < base->count) {
+            str = base->strings + base->entries[id].str;
+            len = base->entries[id].len;
+            hash = base->entries[id].hash;
+        } else {
+            const SymbolEntry* entry = symtab_entry(&global_symtab, id);
+            if (entry) {
+                str = symtab_entry_str(entry);
+                len = entry->len;
+                hash = entry->hash;
+            }
+        }
+        strs[id] = str;
+        entries[id] = (SymbolSnapshotEntry){ .hash = hash, .str = (uint32_t)strings_size, .len = (uint32_t)len };
+        if (len == 0 && id != SYM_EMPTY) entries[id].str = 0;   // 指向空符号的""
+        else strings_size += len + 1;
+        if (strings_size > UINT32_MAX) {
+            free(entries);
+            free(strs);
+            return -1;
+        }
+    }
+
+    // 索引：与分片索引相同的组布局，负载不超过7/8
+    size_t buckets = SYMTAB_GROUP;
+    while ((size_t)count * 8 > buckets * 7) buckets *= 2;
+    SymbolIndex* index = symtab_index_new(buckets);
+    int ret = -1;
+    if (!index) goto out;
+    memset(index->slots, 0, buckets * sizeof(uint32_t));
+    for (uint32_t id = SYM_EMPTY + 1; id < count; ++id) {
+        if (entries[id].len == 0) continue;
+        symtab_place(index, symtab_probe_empty(index, entries[id].hash), id, entries[id].hash);
+    }
+
+    SymbolSnapshotHeader header = {
+        .magic = SYMTAB_SNAPSHOT_MAGIC,
+        .version = SYMTAB_SNAPSHOT_VERSION,
+        .endian = SYMTAB_SNAPSHOT_ENDIAN,
+        .seed = HASH64_SEED,
+        .count = count,
+        .predefined = SYM_COUNT,
+        .buckets = buckets,
+    };
+    header.entries_off = SYMTAB_ALIGN_UP(sizeof(header));
+    header.ctrl_off = SYMTAB_ALIGN_UP(header.entries_off + (uint64_t)count * sizeof(SymbolSnapshotEntry));
+    header.slots_off = SYMTAB_ALIGN_UP(header.ctrl_off + buckets);
+    header.strings_off = SYMTAB_ALIGN_UP(header.slots_off + buckets * sizeof(uint32_t));
+    header.strings_size = strings_size;
+    header.file_size = header.strings_off + strings_size;
+
+    // 先写临时文件再改名：并发读取者只会看到完整的旧文件或新文件
+    size_t tmp_len = strlen(path) + 32;
+    char* tmp = malloc(tmp_len);
+    if (!tmp) goto out;
+    snprintf(tmp, tmp_len, "%s.tmp.%ld", path, (long)getpid());
+    FILE* f = fopen(tmp, "wb");
+    if (f) {
+        uint64_t off = 0;
+        bool ok = symtab_write(f, &header, sizeof(header), &off)
+               && symtab_write(f, entries, (size_t)count * sizeof(SymbolSnapshotEntry), &off)
+               && symtab_write(f, index->ctrl, buckets, &off)
+               && symtab_write(f, index->slots, buckets * sizeof(uint32_t), &off);
+        for (uint32_t id = 0; ok && id < count; ++id) {
+            if (entries[id].len == 0 && id != SYM_EMPTY) continue;
+            ok = fwrite(strs[id], 1, (size_t)entries[id].len + 1, f) == (size_t)entries[id].len + 1;
+        }
+        ok = (fclose(f) == 0) && ok;
+        if (ok && rename(tmp, path) == 0) ret = 0;
+        else unlink(tmp);
+    }
+    free(tmp);
+
+out:
+    symtab_index_free(index);
+    free(entries);
+    free(strs);
+    return ret;
 }
 
-void symbol_unref(Symbol sym) {
-    if (!(sym.flags & SYM_FLAG_INTERNED)) return;
-    
-    SymbolEntry* entry = &global_symtab.entries[sym.id];
-    if (atomic_fetch_sub_explicit(&entry->refcount, 1, memory_order_acq_rel) == 1) {
-        free((void*)entry->str);
-        entry->str = NULL;
+// 头部、各段范围与每个条目的字符串区间校验（O(count)，不触及字符串页面）；
+// 控制字节与槽位不逐一校验，由symtab_base_find限制探测步数并检查ID
+static bool symtab_snapshot_valid(const uint8_t* map, size_t size) {
+    if (size < sizeof(SymbolSnapshotHeader)) return false;
+    const SymbolSnapshotHeader* h = (const SymbolSnapshotHeader*)map;
+    if (h->magic != SYMTAB_SNAPSHOT_MAGIC || h->version != SYMTAB_SNAPSHOT_VERSION ||
+        h->endian != SYMTAB_SNAPSHOT_ENDIAN || h->seed != HASH64_SEED ||
+        h->predefined != SYM_COUNT || h->count < SYM_COUNT || h->file_size != size) {
+        return false;
+    }
+    if (h->buckets < SYMTAB_GROUP || (h->buckets & (h->buckets - 1)) ||
+        h->buckets > ((uint64_t)1 << 40) || (uint64_t)h->count * 8 > h->buckets * 7) {
+        return false;
+    }
+    if (h->entries_off > size || h->ctrl_off > size || h->slots_off > size ||
+        h->strings_off > size || h->strings_size > size) {
+        return false;
     }
+    if (h->entries_off % SYMTAB_SNAPSHOT_ALIGN || h->ctrl_off % SYMTAB_SNAPSHOT_ALIGN ||
+        h->slots_off % SYMTAB_SNAPSHOT_ALIGN ||
+        h->entries_off + (uint64_t)h->count * sizeof(SymbolSnapshotEntry) > size ||
+        h->ctrl_off + h->buckets > size ||
+        h->slots_off + h->buckets * sizeof(uint32_t) > size ||
+        h->strings_size == 0 || h->strings_off + h->strings_size > size ||
+        map[h->strings_off + h->strings_size - 1] != '\0') {
+        return false;
+    }
+
+    // 预定义符号须与本次构建一致
+    const SymbolSnapshotEntry* entries = (const SymbolSnapshotEntry*)(map + h->entries_off);
+    const char* strings = (const char*)(map + h->strings_off);
+    for (uint32_t id = 0; id < SYM_COUNT; ++id) {
+        size_t len = strlen(predefined_strs[id]);
+        if (entries[id].hash != predefined_hashes[id] || entries[id].len != len ||
+            (uint64_t)entries[id].str + len >= h->strings_size ||
+            memcmp(strings + entries[id].str, predefined_strs[id], len + 1) != 0) {
+            return false;
+        }
+    }
+    // 字符串区以'\0'结尾，区间在界内即可保证symbol_str不越界
+    for (uint32_t id = SYM_COUNT; id < h->count; ++id) {
+        if ((uint64_t)entries[id].str + entries[id].len >= h->strings_size) return false;
+    }
+    return true;
 }
 
+int symbol_table_load(const char* path) {
+    pthread_mutex_lock(&global_symtab_init_lock);
+    if (atomic_load_explicit(&global_symtab_ready, memory_order_relaxed)) {
+        pthread_mutex_unlock(&global_symtab_init_lock);
+        return -1;
+    }
+
+    int ret = -1;
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd != -1 && fstat(fd, &st) == 0 && st.st_size > 0) {
+        size_t size = (size_t)st.st_size;
+        uint8_t* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            if (symtab_snapshot_valid(map, size)) {
+                const SymbolSnapshotHeader* h = (const SymbolSnapshotHeader*)map;
+                global_symtab.base = (SymbolSnapshot){
+                    .map = map,
+                    .map_size = size,
+                    .entries = (const SymbolSnapshotEntry*)(map + h->entries_off),
+                    .strings = (const char*)(map + h->strings_off),
+                    .ctrl = map + h->ctrl_off,
+                    .slots = (const uint32_t*)(map + h->slots_off),
+                    .buckets = h->buckets,
+                    .count = h->count,
+                };
+                symbol_table_build();
+                atomic_store_explicit(&global_symtab_ready, true, memory_order_release);
+                ret = 0;
+            } else {
+                munmap(map, size);
+            }
+        }
+    }
+    if (fd != -1) close(fd);
+    pthread_mutex_unlock(&global_symtab_init_lock);
+    return ret;
+}
@@ -9,9 +9,16 @@
 #include <assert.h>
 #include <stdalign.h>
 #include <stdint.h>
+#include <pthread.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 #include "lexer/token.h"
+#include "lexer/literal.h"
+
 
+#define ALIGN_UP_CL(size)   (((size) + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1))
 
 
 // 静态断言验证内存布局
@@ -21,6 +28,8 @@ static_assert(offsetof(Token, next_free) % 1 == 0,
     "next_free must be first field for atomic ops");
 static_assert(sizeof(TokenBlock) % CACHE_LINE_SIZE == 0,
     "TokenBlock alignment violation");
+static_assert(sizeof(Token) == CACHE_LINE_SIZE,
+    "Token payload must fit in one cache line");
 
 
 
@@ -29,29 +38,373 @@ atomic_tp free_list;
 atomic_tbp pool_head = NULL;
 atomic_size_t total_allocated = 0;
 
+
+// 字面量侧表：第k段容量为 LIT_SEG_BASE << k，段地址一经发布不再移动
+#define LIT_SEG_SHIFT       10
+#define LIT_SEG_BASE        (1u << LIT_SEG_SHIFT)
+#define LIT_SEG_COUNT       23                  // 覆盖全部32位索引空间
+
+typedef struct LiteralTable {
+    _Atomic(Literal*) segments[LIT_SEG_COUNT];
+    atomic_uint_fast32_t count;
+} LiteralTable;
+
+static LiteralTable lit_table;
+
 #ifdef DEBUG
 atomic_uint_fast64_t version_wrap_count = 0;
 #endif
 
 
+// 常驻内存统计与上限（以TokenBlock为单位）
+static atomic_size_t tokens_in_use = 0;
+static atomic_size_t pool_blocks = 0;
+static atomic_size_t pool_peak_blocks = 0;
+static atomic_size_t pool_limit_blocks = 0;          // 0表示不限制
+static TokenBlock* pool_spare = NULL;                // 预分配但尚未启用的空块
+static pthread_mutex_t pool_grow_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+// ============================================================================
+// 空闲Token回收策略（构建时选择）
+//  - 默认：全局Treiber栈 + 16字节带版本指针（cmpxchg16b）防ABA
+//  - TOKEN_RECLAIM_MAGAZINE：每线程弹匣 + 全局仓库，仅依赖单字原子操作
+// 两种策略提供相同的内部接口：pop / push / detach / attach / reset
+// ============================================================================
+#if defined(TOKEN_RECLAIM_MAGAZINE)
+
+#define TOKEN_MAG_ROUNDS    64                  // 每个弹匣容纳的Token数
+
+typedef struct TokenMagazine {
+    struct TokenMagazine* next;                 // 仓库链表
+    size_t count;
+    Token* rounds[TOKEN_MAG_ROUNDS];
+} TokenMagazine;
+
+typedef struct TokenDepot {
+    pthread_mutex_t lock;
+    TokenMagazine* full;                        // 非空弹匣
+    TokenMagazine* empty;                       // 空弹匣
+    atomic_size_t tokens;                       // 仓库中的空闲Token数量
+    atomic_uint_fast64_t generation;            // token_pool_cleanup后递增，使线程缓存失效
+} TokenDepot;
+
+typedef struct TokenCache {
+    TokenMagazine* loaded;
+    TokenMagazine* previous;
+    uint64_t generation;
+} TokenCache;
+
+static TokenDepot token_depot = { .lock = PTHREAD_MUTEX_INITIALIZER };
+static __thread TokenCache token_cache;
+static pthread_key_t token_cache_key;
+static pthread_once_t token_cache_once = PTHREAD_ONCE_INIT;
+
+// 线程退出时将弹匣交还仓库
+static void token_cache_release(void* arg) {
+    TokenCache* c = arg;
+    uint64_t gen = atomic_load_explicit(&token_depot.generation, memory_order_acquire);
+    pthread_mutex_lock(&token_depot.lock);
+    TokenMagazine* mags[2] = { c->loaded, c->previous };
+    for (int i = 0; i < 2; ++i) {
+        TokenMagazine* m = mags[i];
+        if (!m) continue;
+        if (c->generation != gen) m->count = 0;
+        if (m->count) {
+            m->next = token_depot.full;
+            token_depot.full = m;
+            atomic_fetch_add_explicit(&token_depot.tokens, m->count, memory_order_relaxed);
+        } else {
+            m->next = token_depot.empty;
+            token_depot.empty = m;
+        }
+    }
+    pthread_mutex_unlock(&token_depot.lock);
+    c->loaded = c->previous = NULL;
+}
+
+static void token_cache_key_init(void) {
+    pthread_key_create(&token_cache_key, token_cache_release);
+}
+
+static TokenCache* token_cache_get(void) {
+    TokenCache* c = &token_cache;
+    uint64_t gen = atomic_load_explicit(&token_depot.generation, memory_order_acquire);
+    if (__builtin_expect(c->loaded && c->generation == gen, 1)) return c;
+
+    if (!c->loaded) {
+        pthread_once(&token_cache_once, token_cache_key_init);
+        c->loaded = calloc(1, sizeof(TokenMagazine));
+        c->previous = calloc(1, sizeof(TokenMagazine));
+        if (!c->loaded || !c->previous) {
+            free(c->loaded);
+            free(c->previous);
+            c->loaded = c->previous = NULL;
+            return NULL;
+        }
+        pthread_setspecific(token_cache_key, c);
+    }
+    // 旧代弹匣中的Token所属块已被释放，直接丢弃
+    c->loaded->count = 0;
+    c->previous->count = 0;
+    c->generation = gen;
+    return c;
+}
+
+static Token* token_reclaim_pop(void) {
+    TokenCache* c = token_cache_get();
+    if (!c) return NULL;
+
+    if (c->loaded->count == 0) {
+        if (c->previous->count > 0) {
+            TokenMagazine* tmp = c->loaded;
+            c->loaded = c->previous;
+            c->previous = tmp;
+        } else {
+            // 用空弹匣向仓库换取一个非空弹匣
+            pthread_mutex_lock(&token_depot.lock);
+            TokenMagazine* full = token_depot.full;
+            if (full) {
+                token_depot.full = full->next;
+                atomic_fetch_sub_explicit(&token_depot.tokens, full->count, memory_order_relaxed);
+                c->previous->next = token_depot.empty;
+                token_depot.empty = c->previous;
+                c->previous = c->loaded;
+                c->loaded = full;
+            }
+            pthread_mutex_unlock(&token_depot.lock);
+            if (!full) return NULL;
+        }
+    }
+    return c->loaded->rounds[--c->loaded->count];
+}
+
+static void token_reclaim_push(Token* token) {
+    TokenCache* c = token_cache_get();
+    if (!c) return;     // 线程缓存不可用：Token留在所属块中，随cleanup回收
+
+    if (c->loaded->count == TOKEN_MAG_ROUNDS) {
+        if (c->previous->count == 0) {
+            TokenMagazine* tmp = c->loaded;
+            c->loaded = c->previous;
+            c->previous = tmp;
+        } else {
+            // 用满弹匣向仓库换取一个空弹匣
+            pthread_mutex_lock(&token_depot.lock);
+            TokenMagazine* empty = token_depot.empty;
+            if (empty) token_depot.empty = empty->next;
+            pthread_mutex_unlock(&token_depot.lock);
+            if (!empty && !(empty = malloc(sizeof(TokenMagazine)))) return;
+
+            pthread_mutex_lock(&token_depot.lock);
+            c->previous->next = token_depot.full;
+            token_depot.full = c->previous;
+            atomic_fetch_add_explicit(&token_depot.tokens, c->previous->count, memory_order_relaxed);
+            pthread_mutex_unlock(&token_depot.lock);
+
+            empty->count = 0;
+            c->previous = c->loaded;
+            c->loaded = empty;
+        }
+    }
+    c->loaded->rounds[c->loaded->count++] = token;
+}
+
+// 摘下仓库与当前线程缓存中的全部空闲Token（仅在静止状态下调用）
+static Token* token_reclaim_detach(void) {
+    Token* chain = NULL;
+    TokenCache* c = token_cache_get();
+    pthread_mutex_lock(&token_depot.lock);
+    while (token_depot.full) {
+        TokenMagazine* m = token_depot.full;
+        token_depot.full = m->next;
+        while (m->count) {
+            Token* t = m->rounds[--m->count];
+            t->next_free = chain;
+            chain = t;
+        }
+        m->next = token_depot.empty;
+        token_depot.empty = m;
+    }
+    atomic_store_explicit(&token_depot.tokens, 0, memory_order_relaxed);
+    pthread_mutex_unlock(&token_depot.lock);
+
+    if (c) {
+        TokenMagazine* mags[2] = { c->loaded, c->previous };
+        for (int i = 0; i < 2; ++i) {
+            while (mags[i]->count) {
+                Token* t = mags[i]->rounds[--mags[i]->count];
+                t->next_free = chain;
+                chain = t;
+            }
+        }
+    }
+    return chain;
+}
+
+// 将空闲链装入弹匣后放回仓库
+static void token_reclaim_attach(Token* chain) {
+    pthread_mutex_lock(&token_depot.lock);
+    while (chain) {
+        TokenMagazine* m = token_depot.empty;
+        if (m) {
+            token_depot.empty = m->next;
+        } else if (!(m = malloc(sizeof(TokenMagazine)))) {
+            break;
+        }
+        m->count = 0;
+        while (chain && m->count < TOKEN_MAG_ROUNDS) {
+            m->rounds[m->count++] = chain;
+            chain = chain->next_free;
+        }
+        m->next = token_depot.full;
+        token_depot.full = m;
+        atomic_fetch_add_explicit(&token_depot.tokens, m->count, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&token_depot.lock);
+}
+
+static void token_reclaim_reset(void) {
+    pthread_mutex_lock(&token_depot.lock);
+    TokenMagazine* lists[2] = { token_depot.full, token_depot.empty };
+    for (int i = 0; i < 2; ++i) {
+        while (lists[i]) {
+            TokenMagazine* next = lists[i]->next;
+            free(lists[i]);
+            lists[i] = next;
+        }
+    }
+    token_depot.full = token_depot.empty = NULL;
+    atomic_store_explicit(&token_depot.tokens, 0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&token_depot.generation, 1, memory_order_release);
+    pthread_mutex_unlock(&token_depot.lock);
+    atomic_init(&free_list, (TaggerPointer){0});
+}
+
+// 线程缓存中的Token按使用中计入（近似值）
+static size_t token_reclaim_in_use(void) {
+    size_t total = atomic_load_explicit(&total_allocated, memory_order_relaxed);
+    size_t cached = atomic_load_explicit(&token_depot.tokens, memory_order_relaxed);
+    return total > cached ? total - cached : 0;
+}
+
+#define TOKEN_IN_USE_INC()      ((void)0)
+#define TOKEN_IN_USE_DEC()      ((void)0)
+
+#else   // 带版本指针的全局空闲链表
+
+static Token* token_reclaim_pop(void) {
+    TaggerPointer old_packed, new_packed;
+    Token* desired = NULL;
+    do {
+        old_packed = atomic_load_explicit(&free_list, memory_order_acquire);
+        desired = (Token*)(old_packed.ptr);
+        if (!desired) break;
+
+        uint64_t ver = old_packed.ver + 1;
+        new_packed = ((TaggerPointer){.ptr = (uint64_t)(desired->next_free), .ver = ver});
+    } while (!atomic_compare_exchange_weak_explicit(
+        &free_list,
+        &old_packed, 
+        new_packed,
+        memory_order_acq_rel, 
+        memory_order_acquire
+    ));
+    return desired;
+}
+
+static void token_reclaim_push(Token* token) {
+    TaggerPointer old_packed, new_packed;
+    do {
+        old_packed = atomic_load_explicit(&free_list, memory_order_acquire);
+        token->next_free = (Token*)(old_packed.ptr);
+        uint64_t ver = old_packed.ver + 1;
+        new_packed = ((TaggerPointer){.ptr = (uint64_t)(token), .ver = ver});
+    } while (!atomic_compare_exchange_weak_explicit(
+        &free_list,
+        &old_packed, 
+        new_packed,
+        memory_order_acq_rel,   // 成功时的内存序
+        memory_order_acquire    // 失败时的内存序
+    ));
+}
+
+static Token* token_reclaim_detach(void) {
+    TaggerPointer detached = atomic_load_explicit(&free_list, memory_order_acquire);
+    atomic_store_explicit(&free_list, ((TaggerPointer){.ptr = 0, .ver = detached.ver + 1}),
+        memory_order_release);
+    return (Token*)detached.ptr;
+}
+
+static void token_reclaim_attach(Token* chain) {
+    TaggerPointer cur = atomic_load_explicit(&free_list, memory_order_acquire);
+    atomic_store_explicit(&free_list, ((TaggerPointer){.ptr = (uint64_t)chain, .ver = cur.ver + 1}),
+        memory_order_release);
+}
+
+static void token_reclaim_reset(void) {
+    atomic_init(&free_list, (TaggerPointer){0});
+}
+
+static size_t token_reclaim_in_use(void) {
+    return atomic_load_explicit(&tokens_in_use, memory_order_relaxed);
+}
+
+#define TOKEN_IN_USE_INC()      atomic_fetch_add_explicit(&tokens_in_use, 1, memory_order_relaxed)
+#define TOKEN_IN_USE_DEC()      atomic_fetch_sub_explicit(&tokens_in_use, 1, memory_order_relaxed)
+
+#endif
+
+
+
+// 分配一个空TokenBlock（调用者持有pool_grow_lock或处于初始化阶段）
+static TokenBlock* token_block_new(void) {
+    TokenBlock* new_block = aligned_alloc(CACHE_LINE_SIZE, sizeof(TokenBlock));
+    if (!new_block) return NULL;
+    new_block->block = aligned_alloc(CACHE_LINE_SIZE, sizeof(Token) * TOKEN_POOL_BLOCK);
+    if (!new_block->block) {
+        free(new_block);
+        return NULL;
+    }
+    atomic_init(&new_block->used, 0);
+    new_block->next = NULL;
+
+    size_t blocks = atomic_fetch_add_explicit(&pool_blocks, 1, memory_order_relaxed) + 1;
+    if (blocks > atomic_load_explicit(&pool_peak_blocks, memory_order_relaxed)) {
+        atomic_store_explicit(&pool_peak_blocks, blocks, memory_order_relaxed);
+    }
+    return new_block;
+}
+
+static void token_block_release(TokenBlock* block) {
+    free(block->block);    // 先释放Token数组
+    free(block);           // 再释放TokenBlock结构体
+    atomic_fetch_sub_explicit(&pool_blocks, 1, memory_order_relaxed);
+}
 
 void token_pool_init(size_t capacity) {
     if(pool_head) return;
 
     size_t block_count = (capacity + TOKEN_POOL_BLOCK - 1) / TOKEN_POOL_BLOCK;
     
+    // 首块作为当前分配块，其余预分配块挂入备用链表
     TokenBlock* head = NULL;
+    TokenBlock* spare = NULL;
     for (size_t i = 0; i < block_count; ++i) {
-        TokenBlock* new_block = aligned_alloc(CACHE_LINE_SIZE, sizeof(TokenBlock));
-        new_block->block = aligned_alloc(CACHE_LINE_SIZE, 
-            sizeof(Token) * TOKEN_POOL_BLOCK);
-        new_block->used = 0;
-        new_block->next = head;
-        head = new_block;
+        TokenBlock* new_block = token_block_new();
+        if (!new_block) break;
+        if (!head) {
+            head = new_block;
+        } else {
+            new_block->next = spare;
+            spare = new_block;
+        }
     }
     atomic_init(&free_list, ((TaggerPointer){.ptr = 0, .ver = 0}));
     atomic_init(&pool_head, head);
     atomic_init(&total_allocated, 0);
+    atomic_init(&tokens_in_use, 0);
+    pool_spare = spare;
 }
 
 void token_pool_cleanup(void) {
@@ -59,59 +412,84 @@ void token_pool_cleanup(void) {
     TokenBlock* current = atomic_exchange_explicit(&pool_head, NULL, memory_order_acquire);
     while (current) {
         TokenBlock* next = current->next;
-        free(current->block);    // 先释放Token数组
-        free(current);           // 再释放TokenBlock结构体
+        token_block_release(current);
+        current = next;
+    }
+    pthread_mutex_lock(&pool_grow_lock);
+    current = pool_spare;
+    pool_spare = NULL;
+    pthread_mutex_unlock(&pool_grow_lock);
+    while (current) {
+        TokenBlock* next = current->next;
+        token_block_release(current);
         current = next;
     }
 
     // 重置原子变量（C11 atomic_init不需要锁）
-    atomic_init(&free_list, (TaggerPointer){0});
+    token_reclaim_reset();
     atomic_init(&total_allocated, 0);
+    atomic_init(&tokens_in_use, 0);
+    atomic_init(&pool_blocks, 0);
+    atomic_init(&pool_peak_blocks, 0);
     atomic_init(&pool_head, NULL);
 
+    // 整体释放字面量侧表
+    for (size_t k = 0; k < LIT_SEG_COUNT; ++k) {
+        free(atomic_exchange_explicit(&lit_table.segments[k], NULL, memory_order_acquire));
+    }
+    atomic_init(&lit_table.count, 0);
+
 #if defined(DEBUG)
     atomic_init(&version_wrap_count, 0);
 #endif
 }
 
-Token* token_alloc(TokenKind type, Span span) {
-    TaggerPointer old_packed, new_packed;
-    Token* desired = NULL;
+// 当前块已满时挂接新块：优先复用备用块，受常驻上限约束
+static bool token_pool_grow(TokenBlock* seen) {
+    bool ok = true;
+    pthread_mutex_lock(&pool_grow_lock);
+    if (atomic_load_explicit(&pool_head, memory_order_acquire) == seen) {
+        TokenBlock* new_block = pool_spare;
+        if (new_block) {
+            pool_spare = new_block->next;
+        } else {
+            size_t limit = atomic_load_explicit(&pool_limit_blocks, memory_order_relaxed);
+            size_t blocks = atomic_load_explicit(&pool_blocks, memory_order_relaxed);
+            new_block = (limit && blocks >= limit) ? NULL : token_block_new();
+        }
+        if (new_block) {
+            new_block->next = seen;
+            atomic_store_explicit(&pool_head, new_block, memory_order_release);
+        } else {
+            ok = false;
+        }
+    }
+    pthread_mutex_unlock(&pool_grow_lock);
+    return ok;
+}
 
+Token* token_alloc(TokenKind type, Span span) {
     // 快速路径
-    do {
-        old_packed = atomic_load_explicit(&free_list, memory_order_acquire);
-        desired = (Token*)(old_packed.ptr);
-        if (!desired) break;
+    Token* desired = token_reclaim_pop();
 
-        uint64_t ver = old_packed.ver + 1;
-        new_packed = ((TaggerPointer){.ptr = (uint64_t)(desired->next_free), .ver = ver});
-    } while (!atomic_compare_exchange_weak_explicit(
-        &free_list,
-        &old_packed, 
-        new_packed,
-        memory_order_acq_rel, 
-        memory_order_acquire
-    ));
-
-    // 慢速路径
-    if (!desired) {
+    // 慢速路径：在当前块内原子递增used，块满则扩容
+    while (!desired) {
         TokenBlock* head = atomic_load_explicit(&pool_head, memory_order_acquire);
-        if (!head || head->used >= TOKEN_POOL_BLOCK) {
-            TokenBlock* new_block = aligned_alloc(CACHE_LINE_SIZE, 
-                sizeof(TokenBlock));
-            new_block->block = aligned_alloc(CACHE_LINE_SIZE, 
-                sizeof(Token) * TOKEN_POOL_BLOCK);
-            new_block->used = 0;
-            new_block->next = head;
-            atomic_store_explicit(&pool_head, new_block, memory_order_release);
-            head = new_block;
+        size_t used = head ? atomic_load_explicit(&head->used, memory_order_relaxed) : TOKEN_POOL_BLOCK;
+        while (used < TOKEN_POOL_BLOCK) {
+            if (atomic_compare_exchange_weak_explicit(&head->used, &used, used + 1,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                desired = &head->block[used];
+                __builtin_prefetch(desired + 1);
+                atomic_fetch_add_explicit(&total_allocated, 1, memory_order_relaxed);
+                break;
+            }
+        }
+        if (!desired && !token_pool_grow(head)) {
+            return NULL;        // 达到常驻上限
         }
-
-        __builtin_prefetch(head->block + head->used);
-        desired = &head->block[head->used++];
-        atomic_fetch_add_explicit(&total_allocated, 1, memory_order_relaxed);
     }
+    TOKEN_IN_USE_INC();
 
     Token init_token = {
         .type = type,
@@ -131,37 +509,215 @@ void token_free(Token* token) {
     }
 #endif
 
-    TaggerPointer old_packed, new_packed;
-    do {
-        memset(token, 0, sizeof(Token));
+    memset(token, 0, sizeof(Token));
+    token_reclaim_push(token);
+    TOKEN_IN_USE_DEC();
+}
 
-        old_packed = atomic_load_explicit(&free_list, memory_order_acquire);
-        token->next_free = (Token*)(old_packed.ptr);
-        uint64_t ver = old_packed.ver + 1;
-        new_packed = ((TaggerPointer){.ptr = (uint64_t)(token), .ver = ver});
-    } while (!atomic_compare_exchange_weak_explicit(
-        &free_list,
-        &old_packed, 
-        new_packed,
-        memory_order_acq_rel,   // 成功时的内存序
-        memory_order_acquire    // 失败时的内存序
-    ));
+
+void token_pool_set_limit(size_t max_tokens) {
+    size_t blocks = (max_tokens + TOKEN_POOL_BLOCK - 1) / TOKEN_POOL_BLOCK;
+    atomic_store_explicit(&pool_limit_blocks, blocks, memory_order_relaxed);
+}
+
+void token_pool_stats(TokenPoolStats* stats) {
+    size_t blocks = atomic_load_explicit(&pool_blocks, memory_order_relaxed);
+    stats->blocks = blocks;
+    stats->resident = blocks * TOKEN_POOL_BLOCK;
+    stats->resident_bytes = blocks * (sizeof(TokenBlock) + sizeof(Token) * TOKEN_POOL_BLOCK);
+    stats->in_use = token_reclaim_in_use();
+    stats->peak_resident = atomic_load_explicit(&pool_peak_blocks, memory_order_relaxed) * TOKEN_POOL_BLOCK;
+    stats->limit = atomic_load_explicit(&pool_limit_blocks, memory_order_relaxed) * TOKEN_POOL_BLOCK;
+}
+
+
+// 修剪时的块描述（按Token数组地址排序，用于定位空闲Token所属块）
+typedef struct TrimEntry {
+    TokenBlock* block;
+    size_t free_count;
+} TrimEntry;
+
+static int trim_entry_cmp(const void* a, const void* b) {
+    uintptr_t x = (uintptr_t)((const TrimEntry*)a)->block->block;
+    uintptr_t y = (uintptr_t)((const TrimEntry*)b)->block->block;
+    return (x > y) - (x < y);
+}
+
+static TrimEntry* trim_entry_find(TrimEntry* entries, size_t n, const Token* token) {
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const Token* base = entries[mid].block->block;
+        if (token < base) {
+            hi = mid;
+        } else if (token >= base + TOKEN_POOL_BLOCK) {
+            lo = mid + 1;
+        } else {
+            return &entries[mid];
+        }
+    }
+    return NULL;
+}
+
+size_t token_pool_trim(size_t keep_tokens) {
+    pthread_mutex_lock(&pool_grow_lock);
+
+    // 统计全部块（活动链表 + 备用链表）
+    size_t n = 0;
+    for (TokenBlock* b = atomic_load_explicit(&pool_head, memory_order_acquire); b; b = b->next) n++;
+    for (TokenBlock* b = pool_spare; b; b = b->next) n++;
+    TrimEntry* entries = n ? malloc(n * sizeof(TrimEntry)) : NULL;
+    if (!entries) {
+        pthread_mutex_unlock(&pool_grow_lock);
+        return 0;
+    }
+    size_t i = 0;
+    for (TokenBlock* b = atomic_load_explicit(&pool_head, memory_order_acquire); b; b = b->next) {
+        entries[i++] = (TrimEntry){b, 0};
+    }
+    for (TokenBlock* b = pool_spare; b; b = b->next) entries[i++] = (TrimEntry){b, 0};
+    qsort(entries, n, sizeof(TrimEntry), trim_entry_cmp);
+
+    // 摘下全部空闲Token并按块计数
+    Token* detached = token_reclaim_detach();
+    for (Token* t = detached; t; t = t->next_free) {
+        TrimEntry* e = trim_entry_find(entries, n, t);
+        if (e) e->free_count++;
+    }
+
+    // 释放完全空闲的块，直到常驻量降至keep_tokens
+    size_t keep_blocks = (keep_tokens + TOKEN_POOL_BLOCK - 1) / TOKEN_POOL_BLOCK;
+    size_t resident = n, released = 0;
+    for (size_t k = 0; k < n && resident > keep_blocks; ++k) {
+        TokenBlock* b = entries[k].block;
+        size_t used = atomic_load_explicit(&b->used, memory_order_relaxed);
+        if (entries[k].free_count == used) {
+            entries[k].free_count = SIZE_MAX;       // 标记为待释放
+            atomic_fetch_sub_explicit(&total_allocated, used, memory_order_relaxed);
+            resident--;
+            released++;
+        }
+    }
+
+    // 重新串联保留块的空闲Token
+    Token* chain = NULL;
+    for (Token* t = detached; t; ) {
+        Token* next = t->next_free;
+        TrimEntry* e = trim_entry_find(entries, n, t);
+        if (!e || e->free_count != SIZE_MAX) {
+            t->next_free = chain;
+            chain = t;
+        }
+        t = next;
+    }
+    token_reclaim_attach(chain);
+
+    // 重建活动链表与备用链表，保持原有顺序
+    TokenBlock* new_head = NULL;
+    TokenBlock** link = &new_head;
+    for (TokenBlock* b = atomic_load_explicit(&pool_head, memory_order_acquire); b; ) {
+        TokenBlock* next = b->next;
+        TrimEntry* e = trim_entry_find(entries, n, b->block);
+        if (e->free_count != SIZE_MAX) {
+            *link = b;
+            link = &b->next;
+        }
+        b = next;
+    }
+    *link = NULL;
+    TokenBlock* new_spare = NULL;
+    link = &new_spare;
+    for (TokenBlock* b = pool_spare; b; ) {
+        TokenBlock* next = b->next;
+        TrimEntry* e = trim_entry_find(entries, n, b->block);
+        if (e->free_count != SIZE_MAX) {
+            *link = b;
+            link = &b->next;
+        }
+        b = next;
+    }
+    *link = NULL;
+    atomic_store_explicit(&pool_head, new_head, memory_order_release);
+    pool_spare = new_spare;
+
+    for (size_t k = 0; k < n; ++k) {
+        if (entries[k].free_count == SIZE_MAX) token_block_release(entries[k].block);
+    }
+    free(entries);
+    pthread_mutex_unlock(&pool_grow_lock);
+
+#ifdef __GLIBC__
+    if (released) malloc_trim(0);   // 将空闲堆页归还操作系统
+#endif
+    return released * (sizeof(TokenBlock) + sizeof(Token) * TOKEN_POOL_BLOCK);
+}
+
+// 索引 -> (段号, 段内偏移)
+static Literal* lit_table_slot(LitId id, bool create) {
+    uint32_t n = (id >> LIT_SEG_SHIFT) + 1;
+    uint32_t k = 31 - __builtin_clz(n);
+    size_t offset = id - (((1u << k) - 1) << LIT_SEG_SHIFT);
+
+    Literal* seg = atomic_load_explicit(&lit_table.segments[k], memory_order_acquire);
+    if (!seg && create) {
+        size_t bytes = sizeof(Literal) * ((size_t)LIT_SEG_BASE << k);
+        Literal* fresh = aligned_alloc(CACHE_LINE_SIZE, ALIGN_UP_CL(bytes));
+        if (!fresh) return NULL;
+        if (atomic_compare_exchange_strong_explicit(&lit_table.segments[k], &seg, fresh,
+                memory_order_acq_rel, memory_order_acquire)) {
+            seg = fresh;
+        } else {
+            free(fresh);        // 其他线程已发布该段
+        }
+    }
+    return seg ? &seg[offset] : NULL;
+}
+
+LitId literal_table_push(Literal lit) {
+    uint_fast32_t id = atomic_fetch_add_explicit(&lit_table.count, 1, memory_order_relaxed);
+    if (id >= LIT_ID_INVALID) return LIT_ID_INVALID;
+
+    Literal* slot = lit_table_slot((LitId)id, true);
+    if (!slot) return LIT_ID_INVALID;
+    *slot = lit;
+    return (LitId)id;
+}
+
+const Literal* literal_table_get(LitId id) {
+    if (id >= atomic_load_explicit(&lit_table.count, memory_order_acquire)) return NULL;
+    return lit_table_slot(id, false);
+}
+
+const Literal* token_literal(const Token* token) {
+    if (token->type != Tk_Literal && token->type != Tk_Error) return NULL;
+    const Literal* lit = literal_table_get(token->data.literal);
+    if (lit && atomic_load_explicit(&lit->state, memory_order_acquire) == LIT_STATE_PENDING) {
+        literal_decode((Literal*)lit);      // 侧表条目本身可写
+    }
+    return lit;
 }
 
 Token* create_literal(Literal lit, Span span) {
     Token* token = token_alloc(Tk_Literal, span);
-    token->data.literal = lit;
+    if (!token) return NULL;
+    token->data.literal = literal_table_push(lit);
+    if (token->data.literal == LIT_ID_INVALID) {
+        token_free(token);      // 侧表已满或扩段失败，不留悬空编号
+        return NULL;
+    }
     return token;
 }
 
 Token* create_ident(Ident ident, Span span) {
     Token* token = token_alloc(Tk_Ident, span);
+    if (!token) return NULL;
     token->data.ident = ident;
     return token;
 }
 
 Token* create_delim(Delimiter delim, bool is_open, Span span) {
     Token* token = token_alloc(is_open ? Tk_OpenDelim : Tk_CloseDelim, span);
+    if (!token) return NULL;
     token->data.delim.delim = delim;
     return token;
 }
@@ -180,22 +736,31 @@ Token* create_punctuation(TokenKind punct_type, Span span) {
 
 Token* create_doc_comment(CommentKind kind, int attr_style, Symbol symbol, Span span) {
     Token* token = token_alloc(Tk_DocComment, span);
+    if (!token) return NULL;
     token->data.doc_comment = (DocComment){kind, attr_style, symbol};
     return token;
 }
 
 Token* create_lifetime(Symbol symbol, bool is_raw, Span span) {
     Token* token = token_alloc(Tk_Lifetime, span);
-    token->data.ident = (Ident){symbol, is_raw, span};
+    if (!token) return NULL;
+    token->data.ident = (Ident){symbol, is_raw};
     return token;
 }
 
 Token* create_error_token(uint32_t error_code, const char* message, Span span) {
     Token* token = token_alloc(Tk_Error, span);
-    token->data.literal = (Literal){
+    if (!token) return NULL;
+    // 错误信息内部化：相同诊断只存一份，无需逐个strdup
+    Symbol msg = message ? symbol_intern(message, strlen(message)) : MACRO_SYM_EMPTY;
+    token->data.literal = literal_table_push((Literal){
         .kind = LIT_ERR,
-        .as.error = {error_code, strdup(message)}
-    };
+        .as.error = {error_code, msg}
+    });
+    if (token->data.literal == LIT_ID_INVALID) {
+        token_free(token);
+        return NULL;
+    }
     return token;
 }
 
@@ -226,5 +791,13 @@ TEST_API TaggerPointer test_get_free_list(void) {
     return atomic_load_explicit(&free_list, memory_order_acquire);
 }
 
+TEST_API size_t test_get_literal_count(void) {
+    return atomic_load_explicit(&lit_table.count, memory_order_relaxed);
+}
+
+TEST_API void test_set_literal_count(size_t count) {
+    atomic_store_explicit(&lit_table.count, count, memory_order_relaxed);
+}
+
 #endif
 
@@ -30,52 +30,46 @@
 #include <assert.h>
 #include <stdalign.h>
 #include <stdint.h>
+#include <time.h>
+#include <sched.h>
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 
 #include "pool/pool.h"
 
 
 #define POOL_TOTAL_SIZE(obj_size, init_cap) \
-    (sizeof(Pool) + NODE_TOTAL_SIZE(obj_size) * capacity)
+    (ALIGN_UP(sizeof(Pool), CACHE_LINE_SIZE) + NODE_TOTAL_SIZE(obj_size) * (init_cap))
 #define BATCH_SIZE              64
-#define CACHE_SIZE              256
-#define CACHE_LOW_THRESHOLD     0.25
-#define CACHE_HIGH_THRESHOLD    0.75
-#define CACHE_LOW_WATERMARK     (CACHE_LOW_THRESHOLD * CACHE_SIZE)
-#define CACHE_HIGH_WATERMARK    (CACHE_HIGH_THRESHOLD * CACHE_SIZE)
-#define PAD_THREAD      ((CACHE_LINE_SIZE - sizeof(size_t)) % CACHE_SIZE*sizeof(void*))
+#define POOL_TLS_SLOTS          8               // 线程本地按Pool地址直接映射的缓存槽数
 #define MIN(a, b)       ((a) < (b) ? (a) : (b))
 #define MAX(a, b)       ((a) > (b) ? (a) : (b))
 
 typedef struct {
-    void* cache[CACHE_SIZE];
-    size_t count;
-    uint8_t _pad[PAD_THREAD];
-} ThreadCache;
+    Pool* pool;
+    PoolCache* cache;
+} PoolCacheSlot;
 
-static __thread ThreadCache thead_cache = { .count = 0 };
+static __thread PoolCacheSlot pool_tls[POOL_TLS_SLOTS];
+static __thread PoolCache* pool_thread_caches = NULL;     // 本线程创建的全部PoolCache
+static pthread_key_t pool_cache_key;
+static pthread_once_t pool_cache_once = PTHREAD_ONCE_INIT;
+// 线程退出与pool_destroy对PoolCache.pool的解绑互斥（锁序：registry → depot）
+static pthread_mutex_t pool_registry_lock = PTHREAD_MUTEX_INITIALIZER;
 
+// 所属线程与回收线程的握手方式（首次创建线程缓存时确定，此后不变）
+//  - 非对称屏障：所属线程只做普通读写，回收线程用membarrier为所有线程补齐全屏障
+//  - CAS：不支持membarrier时，所属线程每次操作以CAS取得缓存使用权
+static bool pool_asym_fence = false;
 
-static atomic_bool reaper_run = ATOMIC_VAR_INIT(false);
-static pthread_t reaper_tid;
-
-void* reaper_thread(void* arg) {
-    Pool* pool = (Pool*)arg;
-    while (atomic_load(&reaper_run)) {
-        nanosleep(&(struct timespec){0, 1000000}, NULL);    // 1ms
-        pool_flush_cache(pool);
-    }
-    return NULL;
-}
-void pool_start_reaper(Pool* pool) {
-    atomic_store(&reaper_run, true);
-    pthread_create(&reaper_tid, NULL, reaper_thread, pool);
-}
-void pool_stop_reaper(Pool* pool) {
-    (void)pool;
-    atomic_store(&reaper_run, false);
-    pthread_join(reaper_tid, NULL);
-}
+#define POOL_TLS_INDEX(pool)    (((uintptr_t)(pool) / CACHE_LINE_SIZE) % POOL_TLS_SLOTS)
+// 线程私有计数器：仅所属线程写入，读改写无需lock前缀
+#define POOL_LOCAL_ADD(counter, n) \
+    atomic_store_explicit(&(counter), atomic_load_explicit(&(counter), memory_order_relaxed) + (n), memory_order_relaxed)
 
 
 // 内存屏障包装
@@ -113,6 +107,16 @@ void pool_stop_reaper(Pool* pool) {
 #endif
 
 
+// 自旋等待提示
+#if defined(__x86_64__) || defined(_M_X64)
+#define CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define CPU_RELAX() asm volatile("yield" ::: "memory")
+#else
+#define CPU_RELAX() COMPILER_BARRIER()
+#endif
+
+
 // 增加退避策略和内存序优化
 #if defined(__x86_64__) || defined(_M_X64)
 #define ALLOC_MO memory_order_acquire
@@ -140,11 +144,41 @@ Pool* pool_create(size_t obj_size, size_t capacity) {
 
     pool->memory = (uint8_t*)pool + ALIGN_UP(sizeof(Pool), CACHE_LINE_SIZE);
     pool->node_size = node_size;
-    pool->capacity = capacity;
+    atomic_init(&pool->capacity, capacity);
+    pool->chunks = NULL;
+    atomic_init(&pool->chunk_count, 1);
+    if (pthread_mutex_init(&pool->grow_lock, NULL) != 0) {
+        aligned_free(pool);
+        return NULL;
+    }
+    if (pthread_mutex_init(&pool->depot.lock, NULL) != 0) {
+        pthread_mutex_destroy(&pool->grow_lock);
+        aligned_free(pool);
+        return NULL;
+    }
+    pool->depot.full = NULL;
+    pool->depot.empty = NULL;
+    pool->depot.full_count = 0;
+    pool->depot.caches = NULL;
+
+    // 回收线程：停止通知使用单调时钟等待
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&pool->reaper.lock, NULL);
+    pthread_cond_init(&pool->reaper.cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+    pool->reaper.running = false;
+    pool->reaper.config = POOL_REAPER_DEFAULT;
+    atomic_init(&pool->reaper.reclaimed, 0);
 
     atomic_init(&pool->alloc_cnt, 0);
     atomic_init(&pool->free_cnt, 0);
     atomic_init(&pool->contention_counter, 0);
+    atomic_init(&pool->stats.cas_success, 0);
+    atomic_init(&pool->stats.cas_fail, 0);
+    atomic_init(&pool->stats.cache_hit, 0);
+    atomic_init(&pool->stats.level, 0);
 
     // 初始化空闲链表（LIFO）
     Node* prev = NULL;
@@ -161,31 +195,166 @@ Pool* pool_create(size_t obj_size, size_t capacity) {
     return pool;
 }
 
-static bool cas_internal(Pool* pool_ptr, atomic_tp_t* target, TaggedPointer* expected, TaggedPointer desired) {
-    bool cas_flag = atomic_compare_exchange_weak_explicit(
+static bool cas_internal(atomic_tp_t* target, TaggedPointer* expected, TaggedPointer desired) {
+    return atomic_compare_exchange_weak_explicit(
         target, expected, desired,
         ALLOC_MO,
         memory_order_relaxed
     );
-    UPDATE_CAS_STATS(pool_ptr, cas_flag);
-    return cas_flag;
 }
 
-void* pool_alloc(Pool* pool) {
-    atomic_tp_t* target_list = &pool->free_list;
-    TaggedPointer old_head, new_head;
-    Node* chunk = NULL;
 
-    old_head = atomic_load_explicit(target_list, ALLOC_MO);
-    if (!old_head.ptr) {
-        target_list = &pool->head;
-        old_head = atomic_load_explicit(target_list, ALLOC_MO);
+// ============================================================================
+// 自适应退避
+//  CAS失败后等待[1, limit]次PAUSE（随机抖动避免各线程同步重试），limit每次失败
+//  翻倍；超过POOL_BACKOFF_SPIN_MAX后改为让出CPU（持有者可能已被换出）。
+//  limit的起点由Pool竞争等级决定：一次操作失败两次以上等级加一，
+//  首次即成功时以1/16概率减一；等级不变时不写共享缓存行。CAS成败次数在操作结束时
+//  一并记入本线程缓存，读取时汇总。
+//  等级达到POOL_CONTENTION_HIGH时，线程缓存从无锁链表补充时一次装满两个弹匣，
+//  回收线程也不再把仓库中的弹匣归还链表，把流量分流到线程缓存与仓库。
+// ============================================================================
+#define POOL_BACKOFF_SPIN_MAX   256u            // 自旋上限（PAUSE次数）
+#define POOL_CONTENTION_MAX     6u              // 竞争等级上限：起点为1<<6次PAUSE
+#define POOL_CONTENTION_HIGH    4u              // 达到该等级时分流到线程缓存
+
+typedef struct {
+    uint32_t limit;             // 本次等待的PAUSE次数上限
+    uint32_t fails;             // 本次操作的CAS失败次数
+} PoolBackoff;
+
+static __thread uint32_t pool_rng = 0;
+
+// xorshift32，仅用于抖动
+static uint32_t pool_random(void) {
+    uint32_t x = pool_rng ? pool_rng : (uint32_t)(uintptr_t)&pool_rng | 1u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return pool_rng = x;
+}
+
+static void pool_backoff_init(Pool* pool, PoolBackoff* backoff) {
+    backoff->limit = 1u << atomic_load_explicit(&pool->stats.level, memory_order_relaxed);
+    backoff->fails = 0;
+}
+
+static void pool_backoff_wait(PoolBackoff* backoff) {
+    backoff->fails++;
+    if (backoff->limit > POOL_BACKOFF_SPIN_MAX) {
+        sched_yield();
+        return;
+    }
+    for (uint32_t n = 1 + pool_random() % backoff->limit; n > 0; --n) {
+        CPU_RELAX();
+    }
+    backoff->limit <<= 1;
+}
+
+static PoolCache* pool_cache_find(Pool* pool);
+
+// CAS计数记在本线程缓存上（仅所属线程写入，读取时汇总），每次尝试不再读改写共享缓存行；
+// 没有缓存的线程（如回收线程）才写Pool上的计数
+static void pool_cas_count(Pool* pool, bool won, uint32_t fails) {
+    PoolCache* c = pool_cache_find(pool);
+    if (c) {
+        if (won) POOL_LOCAL_ADD(c->cas_success, 1);
+        if (fails) POOL_LOCAL_ADD(c->cas_fail, fails);
+        return;
+    }
+    if (won) atomic_fetch_add_explicit(&pool->stats.cas_success, 1, memory_order_relaxed);
+    if (fails) atomic_fetch_add_explicit(&pool->stats.cas_fail, fails, memory_order_relaxed);
+}
+
+// 一次操作结束：won为CAS最终成功（链表为空而放弃时为false）
+static void pool_backoff_done(Pool* pool, const PoolBackoff* backoff, bool won) {
+    pool_cas_count(pool, won, backoff->fails);
+    unsigned level = atomic_load_explicit(&pool->stats.level, memory_order_relaxed);
+    if (backoff->fails >= 2) {
+        if (level < POOL_CONTENTION_MAX) {
+            atomic_store_explicit(&pool->stats.level, level + 1, memory_order_relaxed);
+        }
+    } else if (backoff->fails == 0 && level > 0 && (pool_random() & 15) == 0) {
+        atomic_store_explicit(&pool->stats.level, level - 1, memory_order_relaxed);
+    }
+}
+
+#define POOL_CONTENDED(pool) \
+    (atomic_load_explicit(&(pool)->stats.level, memory_order_relaxed) >= POOL_CONTENTION_HIGH)
+
+
+// 扩容慢路径：seen_cap为调用方观察到链表为空前读取的容量。
+// 持锁后若容量已变化，说明其他线程刚完成扩容，直接返回重试；
+// 否则追加一个chunk并整链压入head。其余线程的无锁分配/释放不受影响。
+static bool pool_grow(Pool* pool, size_t seen_cap) {
+    pthread_mutex_lock(&pool->grow_lock);
+    size_t cap = atomic_load_explicit(&pool->capacity, memory_order_relaxed);
+    if (cap != seen_cap) {
+        pthread_mutex_unlock(&pool->grow_lock);
+        return true;
     }
 
-    do {
-        if (!old_head.ptr) return NULL;
-        chunk = (Node*)old_head.ptr;
-        TaggedPointer next = atomic_load_explicit(&chunk->next, memory_order_relaxed);
+    // 几何增长：追加节点数等于当前容量，单块不超过POOL_CHUNK_MAX_NODES
+    const size_t count = MIN(cap, (size_t)POOL_CHUNK_MAX_NODES);
+    PoolChunk* chunk = aligned_alloc(CACHE_LINE_SIZE, sizeof(PoolChunk) + pool->node_size * count);
+    if (!chunk) {
+        pthread_mutex_unlock(&pool->grow_lock);
+        errno = ENOMEM;
+        return false;
+    }
+    chunk->count = count;
+    chunk->next = pool->chunks;
+    pool->chunks = chunk;
+    atomic_fetch_add_explicit(&pool->chunk_count, 1, memory_order_relaxed);
+
+    // 链接新节点：first→...→last，last再接到当前head
+    uint8_t* base = (uint8_t*)chunk + sizeof(PoolChunk);
+    for (size_t i = 0; i + 1 < count; ++i) {
+        Node* curr = (Node*)(base + i * pool->node_size);
+        atomic_init(&curr->next, tagged_pointer_init(base + (i + 1) * pool->node_size, 0));
+    }
+    Node* first = (Node*)base;
+    Node* last = (Node*)(base + (count - 1) * pool->node_size);
+
+    TaggedPointer old_head = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    TaggedPointer new_head;
+    PoolBackoff backoff;
+    pool_backoff_init(pool, &backoff);
+    for (;;) {
+        atomic_store_explicit(&last->next, tagged_pointer_init(old_head.ptr, 0), memory_order_relaxed);
+        new_head.ptr = (uintptr_t)first;
+        new_head.ver = old_head.ver + 1;
+        bool ok = atomic_compare_exchange_weak_explicit(
+            &pool->head, &old_head, new_head,
+            memory_order_release,
+            memory_order_relaxed
+        );
+        if (ok) break;
+        pool_backoff_wait(&backoff);
+    }
+    pool_backoff_done(pool, &backoff, true);
+
+    atomic_store_explicit(&pool->capacity, cap + count, memory_order_release);
+    pthread_mutex_unlock(&pool->grow_lock);
+    return true;
+}
+
+
+// 从指定链表无锁弹出一个节点，链表为空返回NULL
+static Node* pool_pop(Pool* pool, atomic_tp_t* target_list) {
+    TaggedPointer old_head, new_head;
+    Node* node = NULL;
+    PoolBackoff backoff;
+    pool_backoff_init(pool, &backoff);
+
+    old_head = atomic_load_explicit(target_list, ALLOC_MO);
+    for (;;) {
+        if (!old_head.ptr) {
+            node = NULL;
+            break;
+        }
+        node = (Node*)old_head.ptr;
+        TaggedPointer next = atomic_load_explicit(&node->next, memory_order_relaxed);
 
 #if defined(__GNUC__) || defined(__clang__)
         __builtin_prefetch((void*)next.ptr);
@@ -193,23 +362,36 @@ void* pool_alloc(Pool* pool) {
 
         new_head.ptr = next.ptr;
         new_head.ver = old_head.ver + 1;     
-    } while (!cas_internal(pool, target_list, &old_head, new_head));
+        if (cas_internal(target_list, &old_head, new_head)) break;
+        pool_backoff_wait(&backoff);
+    }
 
-    atomic_fetch_add_explicit(&pool->alloc_cnt, 1, memory_order_relaxed);
-    return chunk->data;
+    pool_backoff_done(pool, &backoff, node != NULL);
+    return node;
 }
 
+static bool pool_depot_return(Pool* pool);
+
+// 无锁链表上的单个分配，链表为空时先取回仓库中的满弹匣，仍没有才扩容
+static Node* pool_list_alloc(Pool* pool) {
+    for (;;) {
+        // 先读容量再检查链表，扩容时据此判断是否已被其他线程抢先扩容
+        size_t cap = atomic_load_explicit(&pool->capacity, memory_order_acquire);
+        Node* node = pool_pop(pool, &pool->free_list);
+        if (!node) node = pool_pop(pool, &pool->head);
+        if (node) return node;
+        if (!pool_depot_return(pool) && !pool_grow(pool, cap)) return NULL;
+    }
+}
 
 
-void pool_free(Pool* pool, void* data) {
-    assert(data != NULL && "Cannot free NULL pointer");
-
-    Node* node = (Node*)((uint8_t*)data - tagged_pointer_size);
-    assert((uint8_t*)node->data == data && "Pointer calculation error");
-    assert(((uintptr_t)node % CACHE_LINE_SIZE) == 0);
 
+// 无锁链表上的单个释放
+static void pool_list_free(Pool* pool, Node* node) {
     TaggedPointer old_head, new_head;
-    do {
+    PoolBackoff backoff;
+    pool_backoff_init(pool, &backoff);
+    for (;;) {
         old_head = atomic_load_explicit(&pool->free_list, memory_order_acquire);
         atomic_store_explicit(
             &node->next,
@@ -219,31 +401,33 @@ void pool_free(Pool* pool, void* data) {
 
         new_head.ptr = (uintptr_t)node;
         new_head.ver = old_head.ver + 1;
-    } while (!atomic_compare_exchange_weak_explicit(
+        bool ok = atomic_compare_exchange_weak_explicit(
             &pool->free_list, &old_head, new_head,
             FREE_MO,
             memory_order_relaxed
-    ));
-
-    atomic_fetch_add_explicit(&pool->free_cnt, 1, memory_order_relaxed);
+        );
+        if (ok) break;
+        pool_backoff_wait(&backoff);
+    }
+    pool_backoff_done(pool, &backoff, true);
 }
 
 
-// 内部批量分配实现
-static size_t batch_alloc_internal(Pool* pool, void** objs, size_t count) {
-    size_t remaining = pool->capacity - (atomic_load(&pool->alloc_cnt) - atomic_load(&pool->free_cnt));
-    if (remaining == 0) return 0;
-    count = MIN(count, remaining);
-
+// 内部批量分配实现：从无锁链表取至多count个对象；链表为空且一个也没取到时，
+// grow为真则先取回仓库中的满弹匣，仓库也为空才扩容，随后重试
+static size_t batch_alloc_internal(Pool* pool, void** objs, size_t count, bool grow) {
     TaggedPointer old_head, new_head;
     Node* chunks[BATCH_SIZE];
     size_t allocated = 0;
-    atomic_tp_t* target_list = &pool->free_list;
 
     while (allocated < count) {
         size_t request = MIN(BATCH_SIZE, count - allocated);
         size_t obtained = 0;
-        do {
+        size_t cap = atomic_load_explicit(&pool->capacity, memory_order_acquire);
+        atomic_tp_t* target_list = &pool->free_list;
+        PoolBackoff backoff;
+        pool_backoff_init(pool, &backoff);
+        for (;;) {
             old_head = atomic_load_explicit(target_list, memory_order_acquire);
             if (!old_head.ptr) {
                 target_list = &pool->head;
@@ -266,12 +450,21 @@ static size_t batch_alloc_internal(Pool* pool, void** objs, size_t count) {
 
             new_head.ptr = (uintptr_t)current;
             new_head.ver = old_head.ver + 1;
-        } while (!cas_internal(pool, target_list, &old_head, new_head));
+            if (cas_internal(target_list, &old_head, new_head)) break;
+            pool_backoff_wait(&backoff);
+        }
+        pool_backoff_done(pool, &backoff, old_head.ptr != 0);
+
+        // 两条链表均为空：已取到部分则返回，否则取回仓库或扩容后重试
+        if (!old_head.ptr) {
+            if (allocated > 0 || !grow) break;
+            if (!pool_depot_return(pool) && !pool_grow(pool, cap)) break;
+            continue;
+        }
 
         for (size_t i = 0; i < obtained; ++i) {
             objs[allocated++] = chunks[i]->data;
         }
-        atomic_fetch_add_explicit(&pool->alloc_cnt, obtained, memory_order_relaxed);
         atomic_fetch_add_explicit(&pool->contention_counter, obtained > 0 ? 0 : 1, memory_order_relaxed);
     }
 
@@ -279,42 +472,6 @@ static size_t batch_alloc_internal(Pool* pool, void** objs, size_t count) {
 }
 
 
-size_t pool_alloc_batch(Pool* pool, void** objs, size_t count) {
-    if (!objs || count == 0) return 0;
-    
-    size_t available = pool->capacity - (atomic_load(&pool->alloc_cnt) - atomic_load(&pool->free_cnt));
-    count = MIN(count, available);
-    size_t from_cache = MIN(count, thead_cache.count);
-
-    // 先从线程缓存分配
-    if (from_cache > 0) {
-        memcpy(objs, &thead_cache.cache[thead_cache.count - from_cache], from_cache * sizeof(void*));
-        thead_cache.count -= from_cache;
-    }
-    
-    // 剩余数量走批量分配
-    size_t batch_allocated = batch_alloc_internal(pool, objs + from_cache, count - from_cache);
-    size_t total_allocated = from_cache + batch_allocated;
-
-    // 处理超额分配（填充本地缓存）
-    if (total_allocated > count) {
-        size_t excess = total_allocated - count;
-        size_t cache_space = CACHE_SIZE - thead_cache.count;
-        size_t to_cache = MIN(excess, cache_space);
-
-        memcpy(&thead_cache.cache[thead_cache.count], objs + count, to_cache * sizeof(void*));
-        thead_cache.count += to_cache;
-
-        // 释放无法缓存的部分
-        if (excess > to_cache) {
-            pool_free_batch(pool, objs + count + to_cache, excess - to_cache);
-        }
-    }
-
-    return MIN(total_allocated, count);
-}
-
-
 // 批量释放函数
 static void pool_free_batch_internal(Pool* pool, void** objs, size_t count) {
     if(count == 0) return;
@@ -332,16 +489,18 @@ static void pool_free_batch_internal(Pool* pool, void** objs, size_t count) {
             chunks[i] = node;
         }
 
-        // 逆序链接节点以保持LIFO
-        for (size_t i = batch-1; i > 0; --i) {
+        // 链接为 chunks[0]→chunks[1]→...→chunks[batch-1]→原表头
+        for (size_t i = 0; i + 1 < batch; ++i) {
             atomic_store_explicit(
                 &chunks[i]->next,
-                tagged_pointer_init(chunks[i-1], 0),
+                tagged_pointer_init(chunks[i+1], 0),
                 memory_order_relaxed
             );
         }
 
-        do {
+        PoolBackoff backoff;
+        pool_backoff_init(pool, &backoff);
+        for (;;) {
             old_head = atomic_load_explicit(&pool->free_list, memory_order_acquire);
             atomic_store_explicit(
                 &chunks[batch-1]->next,
@@ -351,65 +510,583 @@ static void pool_free_batch_internal(Pool* pool, void** objs, size_t count) {
 
             new_head.ptr = (uintptr_t)chunks[0];
             new_head.ver = old_head.ver + 1;
-        } while (!atomic_compare_exchange_weak_explicit(
+            bool ok = atomic_compare_exchange_weak_explicit(
                 &pool->free_list, &old_head, new_head,
                 memory_order_release,
                 memory_order_relaxed
-        ));
+            );
+            if (ok) break;
+            pool_backoff_wait(&backoff);
+        }
+        pool_backoff_done(pool, &backoff, true);
 
         processed += batch;
-        atomic_fetch_add_explicit(&pool->free_cnt, batch, memory_order_relaxed);
     }
 }
 
+// 无锁链表已空时调用：仓库中有满弹匣则整个归还链表（弹匣本身回到空弹匣表），
+// 避免对象闲置在仓库里时仍然扩容。仓库为空返回false
+static bool pool_depot_return(Pool* pool) {
+    pthread_mutex_lock(&pool->depot.lock);
+    PoolMagazine* m = pool->depot.full;
+    if (m) {
+        pool->depot.full = m->next;
+        pool->depot.full_count--;
+    }
+    pthread_mutex_unlock(&pool->depot.lock);
+    if (!m) return false;
+
+    pool_free_batch_internal(pool, m->rounds, m->count);
+    m->count = 0;
+    pthread_mutex_lock(&pool->depot.lock);
+    m->next = pool->depot.empty;
+    pool->depot.empty = m;
+    pthread_mutex_unlock(&pool->depot.lock);
+    return true;
+}
+
+// ============================================================================
+// 线程缓存（每线程每Pool一对弹匣）
+//  快路径只读写线程私有的PoolCache与弹匣；弹匣空/满时在depot.lock下与仓库交换，
+//  仓库也无可用弹匣时才批量访问无锁链表。
+// ============================================================================
+
+// 线程退出：未销毁Pool的弹匣交还仓库，计数并入Pool，随后释放本线程的PoolCache
+static void pool_cache_release(void* arg) {
+    PoolCache* c = *(PoolCache**)arg;
+    while (c) {
+        PoolCache* next = c->thread_next;
+        pthread_mutex_lock(&pool_registry_lock);
+        Pool* pool = atomic_load_explicit(&c->pool, memory_order_relaxed);
+        if (pool) {
+            pthread_mutex_lock(&pool->depot.lock);
+            PoolCache** link = &pool->depot.caches;
+            while (*link != c) link = &(*link)->next;
+            *link = c->next;
+            atomic_fetch_add_explicit(&pool->alloc_cnt, atomic_load_explicit(&c->alloc_cnt, memory_order_relaxed), memory_order_relaxed);
+            atomic_fetch_add_explicit(&pool->free_cnt, atomic_load_explicit(&c->free_cnt, memory_order_relaxed), memory_order_relaxed);
+            atomic_fetch_add_explicit(&pool->stats.cas_success, atomic_load_explicit(&c->cas_success, memory_order_relaxed), memory_order_relaxed);
+            atomic_fetch_add_explicit(&pool->stats.cas_fail, atomic_load_explicit(&c->cas_fail, memory_order_relaxed), memory_order_relaxed);
+            PoolMagazine* mags[2] = { c->loaded, c->previous };
+            for (int i = 0; i < 2; ++i) {
+                PoolMagazine** list = mags[i]->count ? &pool->depot.full : &pool->depot.empty;
+                pool->depot.full_count += mags[i]->count ? 1 : 0;
+                mags[i]->next = *list;
+                *list = mags[i];
+            }
+            pthread_mutex_unlock(&pool->depot.lock);
+        }
+        pthread_mutex_unlock(&pool_registry_lock);
+        aligned_free(c);
+        c = next;
+    }
+    pool_thread_caches = NULL;
+    memset(pool_tls, 0, sizeof(pool_tls));
+}
+
+static void pool_cache_key_init(void) {
+    pthread_key_create(&pool_cache_key, pool_cache_release);
+#if defined(__linux__) && defined(__NR_membarrier)
+    long cmds = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0, 0);
+    pool_asym_fence = cmds > 0 && (cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED)
+        && syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+#endif
+}
+
+// 释放本线程中所属Pool已销毁的PoolCache（pool_destroy已回收其弹匣）。
+//  pool_destroy在registry锁下解绑并遍历depot.caches，持同一把锁观察到pool为NULL时它已不再访问c
+static void pool_cache_sweep(void) {
+    pthread_mutex_lock(&pool_registry_lock);
+    PoolCache** link = &pool_thread_caches;
+    while (*link) {
+        PoolCache* c = *link;
+        if (atomic_load_explicit(&c->pool, memory_order_acquire)) {
+            link = &c->thread_next;
+            continue;
+        }
+        *link = c->thread_next;
+        for (int i = 0; i < POOL_TLS_SLOTS; ++i) {
+            if (pool_tls[i].cache == c) pool_tls[i].pool = NULL, pool_tls[i].cache = NULL;
+        }
+        aligned_free(c);
+    }
+    pthread_mutex_unlock(&pool_registry_lock);
+}
+
+// 查找本线程在pool上的缓存，不存在返回NULL
+static PoolCache* pool_cache_find(Pool* pool) {
+    PoolCacheSlot* slot = &pool_tls[POOL_TLS_INDEX(pool)];
+    // 地址可能被新Pool复用：旧缓存在pool_destroy时已解绑，需同时核对cache->pool
+    if (__builtin_expect(slot->pool == pool, 1)
+        && atomic_load_explicit(&slot->cache->pool, memory_order_relaxed) == pool) {
+        return slot->cache;
+    }
+    for (PoolCache* c = pool_thread_caches; c; c = c->thread_next) {
+        if (atomic_load_explicit(&c->pool, memory_order_relaxed) == pool) {
+            slot->pool = pool;
+            slot->cache = c;
+            return c;
+        }
+    }
+    return NULL;
+}
+
+static PoolCache* pool_cache_create(Pool* pool) {
+    pthread_once(&pool_cache_once, pool_cache_key_init);
+    pool_cache_sweep();
+
+    PoolCache* c = aligned_alloc(CACHE_LINE_SIZE, sizeof(PoolCache));
+    PoolMagazine* loaded = malloc(sizeof(PoolMagazine));
+    PoolMagazine* previous = malloc(sizeof(PoolMagazine));
+    if (!c || !loaded || !previous) {
+        aligned_free(c);
+        free(loaded);
+        free(previous);
+        return NULL;
+    }
+    loaded->count = previous->count = 0;
+    c->loaded = loaded;
+    c->previous = previous;
+    atomic_init(&c->alloc_cnt, 0);
+    atomic_init(&c->free_cnt, 0);
+    atomic_init(&c->cas_success, 0);
+    atomic_init(&c->cas_fail, 0);
+    atomic_init(&c->pool, pool);
+    atomic_init(&c->state, POOL_CACHE_IDLE);
+    atomic_init(&c->reclaim, 0);
+    c->idle_scans = 0;
+    c->seen_ops = 0;
+
+    pthread_mutex_lock(&pool->depot.lock);
+    c->next = pool->depot.caches;
+    pool->depot.caches = c;
+    pthread_mutex_unlock(&pool->depot.lock);
+
+    c->thread_next = pool_thread_caches;
+    pool_thread_caches = c;
+    pthread_setspecific(pool_cache_key, &pool_thread_caches);
+
+    PoolCacheSlot* slot = &pool_tls[POOL_TLS_INDEX(pool)];
+    slot->pool = pool;
+    slot->cache = c;
+    return c;
+}
+
+static PoolCache* pool_cache_get(Pool* pool) {
+    PoolCache* c = pool_cache_find(pool);
+    return c ? c : pool_cache_create(pool);
+}
+
+// 取得本线程缓存的使用权；正被回收线程清空时返回false，调用方改走无锁链表
+static bool pool_cache_enter(PoolCache* c) {
+    if (pool_asym_fence) {
+        atomic_store_explicit(&c->state, POOL_CACHE_BUSY, memory_order_relaxed);
+        atomic_signal_fence(memory_order_seq_cst);      // 与回收线程的membarrier配对
+        if (__builtin_expect(!atomic_load_explicit(&c->reclaim, memory_order_acquire), 1)) return true;
+        atomic_store_explicit(&c->state, POOL_CACHE_IDLE, memory_order_relaxed);
+        return false;
+    }
+    unsigned idle = POOL_CACHE_IDLE;
+    return atomic_compare_exchange_strong_explicit(
+        &c->state, &idle, POOL_CACHE_BUSY,
+        memory_order_acquire,
+        memory_order_relaxed
+    );
+}
+
+static void pool_cache_leave(PoolCache* c) {
+    atomic_store_explicit(&c->state, POOL_CACHE_IDLE, memory_order_release);
+}
+
+// loaded为空时补充：previous非空则交换；否则用空弹匣向仓库换一个满弹匣；
+// 仓库也没有则从无锁链表批量取一弹匣（必要时扩容）
+static bool pool_cache_refill(Pool* pool, PoolCache* c) {
+    PoolMagazine* tmp;
+    if (c->previous->count > 0) {
+        tmp = c->loaded;
+        c->loaded = c->previous;
+        c->previous = tmp;
+        return true;
+    }
+
+    pthread_mutex_lock(&pool->depot.lock);
+    PoolMagazine* full = pool->depot.full;
+    if (full) {
+        pool->depot.full = full->next;
+        pool->depot.full_count--;
+        c->previous->next = pool->depot.empty;
+        pool->depot.empty = c->previous;
+        c->previous = c->loaded;
+        c->loaded = full;
+    }
+    pthread_mutex_unlock(&pool->depot.lock);
+    if (full) return true;
+
+    c->loaded->count = batch_alloc_internal(pool, c->loaded->rounds, POOL_MAG_ROUNDS, true);
+    // 高竞争：previous也一并装满，下次补充前不再访问链表
+    if (c->loaded->count == POOL_MAG_ROUNDS && POOL_CONTENDED(pool)) {
+        c->previous->count = batch_alloc_internal(pool, c->previous->rounds, POOL_MAG_ROUNDS, false);
+    }
+    return c->loaded->count > 0;
+}
+
+// loaded已满时腾出空间：previous为空则交换；否则把previous作为满弹匣交给仓库，
+// 换回一个空弹匣（仓库没有则新分配）。分配失败返回false
+static bool pool_cache_spill(Pool* pool, PoolCache* c) {
+    PoolMagazine* tmp;
+    if (c->previous->count == 0) {
+        tmp = c->loaded;
+        c->loaded = c->previous;
+        c->previous = tmp;
+        return true;
+    }
+
+    pthread_mutex_lock(&pool->depot.lock);
+    PoolMagazine* empty = pool->depot.empty;
+    if (empty) {
+        pool->depot.empty = empty->next;
+    }
+    pthread_mutex_unlock(&pool->depot.lock);
+    if (!empty && !(empty = malloc(sizeof(PoolMagazine)))) return false;
+
+    pthread_mutex_lock(&pool->depot.lock);
+    c->previous->next = pool->depot.full;
+    pool->depot.full = c->previous;
+    pool->depot.full_count++;
+    pthread_mutex_unlock(&pool->depot.lock);
+
+    empty->count = 0;
+    c->previous = c->loaded;
+    c->loaded = empty;
+    return true;
+}
+
+
+void* pool_alloc(Pool* pool) {
+    PoolCache* c = pool_cache_get(pool);
+    if (__builtin_expect(c != NULL, 1) && pool_cache_enter(c)) {
+        void* data = NULL;
+        if (c->loaded->count > 0 || pool_cache_refill(pool, c)) {
+            data = c->loaded->rounds[--c->loaded->count];
+            POOL_LOCAL_ADD(c->alloc_cnt, 1);
+        }
+        pool_cache_leave(c);
+        return data;
+    }
+
+    // 线程缓存不可用（内存不足或正被回收）：直接走无锁链表
+    Node* node = pool_list_alloc(pool);
+    if (!node) return NULL;
+    atomic_fetch_add_explicit(&pool->alloc_cnt, 1, memory_order_relaxed);
+    return node->data;
+}
+
+
+void pool_free(Pool* pool, void* data) {
+    assert(data != NULL && "Cannot free NULL pointer");
+
+    Node* node = (Node*)((uint8_t*)data - tagged_pointer_size);
+    assert((uint8_t*)node->data == data && "Pointer calculation error");
+    assert(((uintptr_t)node % CACHE_LINE_SIZE) == 0);
+
+    PoolCache* c = pool_cache_get(pool);
+    if (__builtin_expect(c != NULL, 1) && pool_cache_enter(c)) {
+        bool cached = c->loaded->count < POOL_MAG_ROUNDS || pool_cache_spill(pool, c);
+        if (cached) {
+            c->loaded->rounds[c->loaded->count++] = data;
+            POOL_LOCAL_ADD(c->free_cnt, 1);
+        }
+        pool_cache_leave(c);
+        if (cached) return;
+    }
+
+    pool_list_free(pool, node);
+    atomic_fetch_add_explicit(&pool->free_cnt, 1, memory_order_relaxed);
+}
+
+
+size_t pool_alloc_batch(Pool* pool, void** objs, size_t count) {
+    if (!objs || count == 0) return 0;
+
+    size_t allocated = 0;
+    PoolCache* c = pool_cache_get(pool);
+    if (c && pool_cache_enter(c)) {
+        // 逐弹匣整段拷出
+        while (allocated < count) {
+            if (c->loaded->count == 0 && !pool_cache_refill(pool, c)) break;
+            size_t n = MIN(c->loaded->count, count - allocated);
+            c->loaded->count -= n;
+            memcpy(objs + allocated, &c->loaded->rounds[c->loaded->count], n * sizeof(void*));
+            allocated += n;
+        }
+        POOL_LOCAL_ADD(c->alloc_cnt, allocated);
+        pool_cache_leave(c);
+        return allocated;
+    }
+
+    while (allocated < count) {
+        size_t n = batch_alloc_internal(pool, objs + allocated, count - allocated, true);
+        if (n == 0) break;
+        allocated += n;
+    }
+    atomic_fetch_add_explicit(&pool->alloc_cnt, allocated, memory_order_relaxed);
+    return allocated;
+}
+
+
 // 批量释放函数
 void pool_free_batch(Pool* pool, void** objs, size_t count) {
     if (!objs || count == 0) return;
-    
-    if (thead_cache.count >= CACHE_HIGH_WATERMARK) {
-        size_t release = thead_cache.count - CACHE_HIGH_WATERMARK;
-        pool_free_batch_internal(pool, thead_cache.cache, release);
-        thead_cache.count -= release;
-        memmove(
-            thead_cache.cache, 
-            &thead_cache.cache[release], 
-            thead_cache.count * sizeof(void*)
-        );
-    }
 
-    // 1.尝试缓存释放对象
-    size_t to_cache = MIN(count, CACHE_SIZE - thead_cache.count);
-    if (to_cache > 0) {
-        memcpy(&thead_cache.cache[thead_cache.count], objs, to_cache * sizeof(void*));
-        thead_cache.count += to_cache;
-        count -= to_cache;
-        objs += to_cache;
+    size_t cached = 0;
+    PoolCache* c = pool_cache_get(pool);
+    if (c && pool_cache_enter(c)) {
+        while (cached < count) {
+            if (c->loaded->count == POOL_MAG_ROUNDS && !pool_cache_spill(pool, c)) break;
+            size_t n = MIN(POOL_MAG_ROUNDS - c->loaded->count, count - cached);
+            memcpy(&c->loaded->rounds[c->loaded->count], objs + cached, n * sizeof(void*));
+            c->loaded->count += n;
+            cached += n;
+        }
+        POOL_LOCAL_ADD(c->free_cnt, cached);
+        pool_cache_leave(c);
     }
-    if (count > 0) {
-        pool_free_batch_internal(pool, objs, count);
+
+    // 线程缓存不可用或正被回收：剩余对象直接归还无锁链表
+    if (cached < count) {
+        pool_free_batch_internal(pool, objs + cached, count - cached);
+        atomic_fetch_add_explicit(&pool->free_cnt, count - cached, memory_order_relaxed);
     }
 }
 
 
-// 刷新缓存
+// 刷新缓存：当前线程在pool上的弹匣全部归还无锁链表
 void pool_flush_cache(Pool* pool) {
-    if (thead_cache.count > 0) {
-        pool_free_batch_internal(pool, thead_cache.cache, thead_cache.count);
-        thead_cache.count = 0;
+    PoolCache* c = pool_cache_find(pool);
+    if (!c || !pool_cache_enter(c)) return;
+    PoolMagazine* mags[2] = { c->loaded, c->previous };
+    for (int i = 0; i < 2; ++i) {
+        pool_free_batch_internal(pool, mags[i]->rounds, mags[i]->count);
+        mags[i]->count = 0;
     }
+    pool_cache_leave(c);
+}
+
+
+// 汇总计数：Pool自身计数 + 各已注册线程缓存计数（调用方持有depot.lock）
+static void pool_counts_locked(Pool* pool, uintptr_t* alloc, uintptr_t* freed) {
+    *alloc = atomic_load_explicit(&pool->alloc_cnt, memory_order_relaxed);
+    *freed = atomic_load_explicit(&pool->free_cnt, memory_order_relaxed);
+    for (PoolCache* c = pool->depot.caches; c; c = c->next) {
+        *alloc += atomic_load_explicit(&c->alloc_cnt, memory_order_relaxed);
+        *freed += atomic_load_explicit(&c->free_cnt, memory_order_relaxed);
+    }
+}
+
+static void pool_counts(Pool* pool, uintptr_t* alloc, uintptr_t* freed) {
+    pthread_mutex_lock(&pool->depot.lock);
+    pool_counts_locked(pool, alloc, freed);
+    pthread_mutex_unlock(&pool->depot.lock);
+}
+
+// 汇总CAS计数，方式同pool_counts
+static void pool_cas_counts(Pool* pool, uintptr_t* success, uintptr_t* fail) {
+    pthread_mutex_lock(&pool->depot.lock);
+    *success = atomic_load_explicit(&pool->stats.cas_success, memory_order_relaxed);
+    *fail = atomic_load_explicit(&pool->stats.cas_fail, memory_order_relaxed);
+    for (PoolCache* c = pool->depot.caches; c; c = c->next) {
+        *success += atomic_load_explicit(&c->cas_success, memory_order_relaxed);
+        *fail += atomic_load_explicit(&c->cas_fail, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&pool->depot.lock);
+}
+
+
+// ============================================================================
+// 回收线程
+//  空闲判定：线程缓存的分配+释放计数连续idle_periods次扫描不变。
+//  非对称屏障模式：先对空闲缓存置reclaim，membarrier后仍为IDLE的缓存才清空；
+//  所属线程要么看到reclaim改走无锁链表，要么其BUSY对回收线程可见。
+//  CAS模式：以CAS将state由IDLE置为RECLAIM，所属线程进入操作会CAS失败。
+//  两种模式下弹匣都只会被一方修改。整个扫描持有depot.lock，线程退出与
+//  弹匣交换都需要该锁，不会与回收交错。
+// ============================================================================
+
+// 清空一个已取得使用权的线程缓存：先清previous，loaded中保留至多cache_low个
+static size_t pool_reap_cache(Pool* pool, PoolCache* c, const PoolReaperConfig* config) {
+    size_t reclaimed = 0;
+    size_t keep = config->cache_low;
+    PoolMagazine* mags[2] = { c->previous, c->loaded };
+    for (int i = 0; i < 2; ++i) {
+        size_t kept = MIN(keep, mags[i]->count);
+        keep -= kept;
+        pool_free_batch_internal(pool, &mags[i]->rounds[kept], mags[i]->count - kept);
+        reclaimed += mags[i]->count - kept;
+        mags[i]->count = kept;
+    }
+    return reclaimed;
+}
+
+// depot.lock只在摘取缓存表头与超出高水位的满弹匣时持有，membarrier与归还无锁链表的CAS
+//  均在锁外进行，不阻塞其他线程的弹匣交换。遍历与回收线程缓存期间持registry锁：
+//  线程退出须先取该锁才能摘除并释放自己的PoolCache；新缓存只插在表头，不影响已取得的表
+static void pool_reap(Pool* pool, const PoolReaperConfig* config) {
+    uintptr_t reclaimed = 0;
+    size_t pending = 0;
+    PoolMagazine* excess = NULL;
+
+    pthread_mutex_lock(&pool_registry_lock);
+    pthread_mutex_lock(&pool->depot.lock);
+    PoolCache* caches = pool->depot.caches;
+    // 仓库超过高水位：满弹匣摘至本地直至低水位（高竞争时暂缓，留给弹匣交换）
+    if (pool->depot.full_count > config->depot_high && !POOL_CONTENDED(pool)) {
+        while (pool->depot.full_count > config->depot_low) {
+            PoolMagazine* m = pool->depot.full;
+            pool->depot.full = m->next;
+            pool->depot.full_count--;
+            m->next = excess;
+            excess = m;
+        }
+    }
+    pthread_mutex_unlock(&pool->depot.lock);
+
+    for (PoolCache* c = caches; c; c = c->next) {
+        uintptr_t ops = atomic_load_explicit(&c->alloc_cnt, memory_order_relaxed)
+                      + atomic_load_explicit(&c->free_cnt, memory_order_relaxed);
+        if (ops != c->seen_ops) {
+            c->seen_ops = ops;
+            c->idle_scans = 0;
+            continue;
+        }
+        if (c->idle_scans < config->idle_periods) {
+            c->idle_scans++;
+            continue;
+        }
+
+        if (pool_asym_fence) {
+            atomic_store_explicit(&c->reclaim, 1, memory_order_relaxed);
+            pending++;
+            continue;
+        }
+        unsigned idle = POOL_CACHE_IDLE;
+        if (atomic_compare_exchange_strong_explicit(
+                &c->state, &idle, POOL_CACHE_RECLAIM,
+                memory_order_acquire,
+                memory_order_relaxed)) {
+            reclaimed += pool_reap_cache(pool, c, config);
+            atomic_store_explicit(&c->state, POOL_CACHE_IDLE, memory_order_release);
+        }
+    }
+
+#if defined(__linux__) && defined(__NR_membarrier)
+    if (pending) {
+        bool fenced = syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0) == 0;
+        for (PoolCache* c = caches; c; c = c->next) {
+            if (!atomic_load_explicit(&c->reclaim, memory_order_relaxed)) continue;
+            if (fenced && atomic_load_explicit(&c->state, memory_order_acquire) == POOL_CACHE_IDLE) {
+                reclaimed += pool_reap_cache(pool, c, config);
+            }
+            atomic_store_explicit(&c->reclaim, 0, memory_order_release);
+        }
+    }
+#endif
+    pthread_mutex_unlock(&pool_registry_lock);
+
+    if (excess) {
+        PoolMagazine* last = excess;
+        for (PoolMagazine* m = excess; m; m = m->next) {
+            pool_free_batch_internal(pool, m->rounds, m->count);
+            reclaimed += m->count;
+            m->count = 0;
+            last = m;
+        }
+        pthread_mutex_lock(&pool->depot.lock);
+        last->next = pool->depot.empty;
+        pool->depot.empty = excess;
+        pthread_mutex_unlock(&pool->depot.lock);
+    }
+
+    if (reclaimed) {
+        atomic_fetch_add_explicit(&pool->reaper.reclaimed, reclaimed, memory_order_relaxed);
+    }
+}
+
+static void* pool_reaper_thread(void* arg) {
+    Pool* pool = (Pool*)arg;
+    pthread_mutex_lock(&pool->reaper.lock);
+    while (pool->reaper.running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        uint64_t ns = (uint64_t)deadline.tv_nsec + (uint64_t)pool->reaper.config.period_us * 1000;
+        deadline.tv_sec += ns / 1000000000;
+        deadline.tv_nsec = ns % 1000000000;
+        pthread_cond_timedwait(&pool->reaper.cond, &pool->reaper.lock, &deadline);
+        if (!pool->reaper.running) break;
+
+        PoolReaperConfig config = pool->reaper.config;
+        pthread_mutex_unlock(&pool->reaper.lock);
+        pool_reap(pool, &config);
+        pthread_mutex_lock(&pool->reaper.lock);
+    }
+    pthread_mutex_unlock(&pool->reaper.lock);
+    return NULL;
+}
+
+// 启动回收线程；已在运行返回-1（EBUSY），参数非法返回-1（EINVAL）
+int pool_start_reaper_config(Pool* pool, const PoolReaperConfig* config) {
+    if (!pool || !config || config->period_us == 0 || config->depot_low > config->depot_high) {
+        errno = EINVAL;
+        return -1;
+    }
+    pthread_mutex_lock(&pool->reaper.lock);
+    if (pool->reaper.running) {
+        pthread_mutex_unlock(&pool->reaper.lock);
+        errno = EBUSY;
+        return -1;
+    }
+    pool->reaper.config = *config;
+    pool->reaper.running = true;
+    int err = pthread_create(&pool->reaper.tid, NULL, pool_reaper_thread, pool);
+    if (err) pool->reaper.running = false;
+    pthread_mutex_unlock(&pool->reaper.lock);
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+void pool_start_reaper(Pool* pool) {
+    pool_start_reaper_config(pool, &POOL_REAPER_DEFAULT);
+}
+
+void pool_stop_reaper(Pool* pool) {
+    pthread_mutex_lock(&pool->reaper.lock);
+    if (!pool->reaper.running) {
+        pthread_mutex_unlock(&pool->reaper.lock);
+        return;
+    }
+    pool->reaper.running = false;
+    pthread_t tid = pool->reaper.tid;
+    pthread_cond_signal(&pool->reaper.cond);
+    pthread_mutex_unlock(&pool->reaper.lock);
+    pthread_join(tid, NULL);
 }
 
 
 void show_pool_info(Pool* pool) {
     printf("Pool Info:\n");
     printf("  Memory: %p\n", pool->memory);
-    printf("  Capacity: %zu\n", pool->capacity);
+    printf("  Capacity: %zu\n", atomic_load_explicit(&pool->capacity, memory_order_relaxed));
+    printf("  Chunks: %zu\n", atomic_load_explicit(&pool->chunk_count, memory_order_relaxed));
     printf("  Node Size: %zu\n", pool->node_size);
-    printf("  Allocated: %zu\n", atomic_load_explicit(&pool->alloc_cnt, memory_order_relaxed));
-    printf("  Free: %zu\n", atomic_load_explicit(&pool->free_cnt, memory_order_relaxed));
+    uintptr_t alloc, freed;
+    pool_counts(pool, &alloc, &freed);
+    printf("  Allocated: %zu\n", alloc);
+    printf("  Free: %zu\n", freed);
     printf("  Contention Counter: %zu\n", atomic_load_explicit(&pool->contention_counter, memory_order_relaxed));
-    size_t cas_success = atomic_load(&pool->stats.cas_success);
-    size_t cas_fail = atomic_load(&pool->stats.cas_fail);
+    uintptr_t cas_success, cas_fail;
+    pool_cas_counts(pool, &cas_success, &cas_fail);
     printf("  CAS(su/per): %.2f%%\n", 
         100.0 * (double) cas_success/ ((double)cas_success + (double)cas_fail)
     );
@@ -419,10 +1096,12 @@ void pool_destroy(Pool** pool_ptr) {
     if(!pool_ptr) return;
     Pool* pool = *pool_ptr;
     if (pool) {
-        pool_flush_cache(pool);
-        // 验证所有对象已回收
-        uintptr_t alloc = atomic_load_explicit(&pool->alloc_cnt, memory_order_acquire);
-        uintptr_t freed = atomic_load_explicit(&pool->free_cnt, memory_order_acquire);
+        pool_stop_reaper(pool);
+        pthread_mutex_lock(&pool_registry_lock);
+        pthread_mutex_lock(&pool->depot.lock);
+        // 验证所有对象已回收（含各线程缓存中的计数）
+        uintptr_t alloc, freed;
+        pool_counts_locked(pool, &alloc, &freed);
 
         if (alloc != freed) {
 #ifdef _WIN32
@@ -433,6 +1112,37 @@ void pool_destroy(Pool** pool_ptr) {
             abort();
         }
 
+        // 回收弹匣并解绑各线程缓存；PoolCache本身由所属线程释放
+        // 先取next：解绑后所属线程即可释放c
+        PoolCache* next;
+        for (PoolCache* c = pool->depot.caches; c; c = next) {
+            next = c->next;
+            free(c->loaded);
+            free(c->previous);
+            c->loaded = c->previous = NULL;
+            atomic_store_explicit(&c->pool, NULL, memory_order_release);
+        }
+        PoolMagazine* lists[2] = { pool->depot.full, pool->depot.empty };
+        for (int i = 0; i < 2; ++i) {
+            while (lists[i]) {
+                PoolMagazine* next = lists[i]->next;
+                free(lists[i]);
+                lists[i] = next;
+            }
+        }
+        pthread_mutex_unlock(&pool->depot.lock);
+        pthread_mutex_unlock(&pool_registry_lock);
+
+        PoolChunk* chunk = pool->chunks;
+        while (chunk) {
+            PoolChunk* next = chunk->next;
+            aligned_free(chunk);
+            chunk = next;
+        }
+        pthread_mutex_destroy(&pool->grow_lock);
+        pthread_mutex_destroy(&pool->depot.lock);
+        pthread_mutex_destroy(&pool->reaper.lock);
+        pthread_cond_destroy(&pool->reaper.cond);
         aligned_free(pool);
         *pool_ptr = NULL;
     }
@@ -451,17 +1161,45 @@ void pool_destroy(Pool** pool_ptr) {
 #endif
 
 TEST_API size_t get_alloc_cnt(Pool* pool) {
-    return atomic_load_explicit(&pool->alloc_cnt, memory_order_relaxed);
+    uintptr_t alloc, freed;
+    pool_counts(pool, &alloc, &freed);
+    return alloc;
 }
 
 TEST_API size_t get_free_cnt(Pool* pool) {
-    return atomic_load_explicit(&pool->free_cnt, memory_order_relaxed);
+    uintptr_t alloc, freed;
+    pool_counts(pool, &alloc, &freed);
+    return freed;
 }
 
 TEST_API size_t get_contention_counter(Pool* pool) {
     return atomic_load_explicit(&pool->contention_counter, memory_order_relaxed);
 }
 
+TEST_API size_t get_capacity(Pool* pool) {
+    return atomic_load_explicit(&pool->capacity, memory_order_relaxed);
+}
+
+TEST_API size_t get_chunk_count(Pool* pool) {
+    return atomic_load_explicit(&pool->chunk_count, memory_order_relaxed);
+}
+
+TEST_API size_t get_cas_success(Pool* pool) {
+    uintptr_t success, fail;
+    pool_cas_counts(pool, &success, &fail);
+    return success;
+}
+
+TEST_API size_t get_cas_fail(Pool* pool) {
+    uintptr_t success, fail;
+    pool_cas_counts(pool, &success, &fail);
+    return fail;
+}
+
+TEST_API size_t get_reclaimed_cnt(Pool* pool) {
+    return atomic_load_explicit(&pool->reaper.reclaimed, memory_order_relaxed);
+}
+
 #endif 
 
 
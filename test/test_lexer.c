@@ -0,0 +1,985 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "lexer/lexer.h"
+#include "lexer/literal.h"
+#include "lexer/scan.h"
+#include "lexer/ring.h"
+#include "api_token.h"
+
+#define MACRO_UNUSED(x) (void)(x)
+#define LEX_MIN(a, b)   ((a) < (b) ? (a) : (b))
+
+
+// 将Token流的类型序列与期望比较
+static void assert_kinds(const TokenStream* stream, const TokenKind* kinds, size_t n) {
+    assert_int_equal(stream->count, n);
+    const Token* t = stream->head;
+    for (size_t i = 0; i < n; i++, t = t->next) {
+        assert_non_null(t);
+        assert_int_equal(t->type, kinds[i]);
+    }
+    assert_null(t);
+}
+
+// 比较两条Token流的类型与位置
+static void assert_streams_equal(const TokenStream* a, const TokenStream* b) {
+    assert_int_equal(a->count, b->count);
+    const Token* x = a->head;
+    const Token* y = b->head;
+    for (; x && y; x = x->next, y = y->next) {
+        assert_int_equal(x->type, y->type);
+        assert_int_equal(SPAN_KEY(x->span), SPAN_KEY(y->span));
+        if (x->type == Tk_OpenDelim || x->type == Tk_CloseDelim) {
+            const Token* mx = x->data.delim.match;
+            const Token* my = y->data.delim.match;
+            assert_int_equal(mx != NULL, my != NULL);
+            if (mx) assert_int_equal(SPAN_KEY(mx->span), SPAN_KEY(my->span));
+        }
+        if (x->type == Tk_Literal && LIT_IS_STRING(token_literal(x)->kind)) {
+            assert_string_equal(symbol_str(token_literal(x)->symbol), symbol_str(token_literal(y)->symbol));
+        }
+    }
+    assert_null(x);
+    assert_null(y);
+}
+
+
+// ==============================================================
+/// @brief 基础功能测试::运算符、分隔符与标识符
+/// @param state
+static void test_lex_basic(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    const char* src = "fn main() { let x: u32 = a::b >>= 1 ..= 2; }";
+    TokenStream ts;
+    assert_int_equal(lexer_tokenize(src, strlen(src), &ts), 0);
+
+    const TokenKind kinds[] = {
+        Tk_Ident, Tk_Ident, Tk_OpenDelim, Tk_CloseDelim, Tk_OpenDelim,
+        Tk_Ident, Tk_Ident, Tk_Colon, Tk_Ident, Tk_Eq,
+        Tk_Ident, Tk_PathSep, Tk_Ident, Tk_ShrEq, Tk_Literal, Tk_DotDotEq, Tk_Literal, Tk_Semi,
+        Tk_CloseDelim, Tk_Eof,
+    };
+    assert_kinds(&ts, kinds, sizeof(kinds) / sizeof(kinds[0]));
+    assert_string_equal(symbol_str(ts.head->data.ident.symbol), "fn");
+    assert_int_equal(ts.head->next->span.lo, 3);
+    assert_int_equal(SPAN_HI(ts.head->next->span), 7);
+
+    token_stream_free(&ts);
+    token_pool_cleanup();
+}
+// ==============================================================
+/// @brief 字面量与注释::字符串、原始字符串、数字后缀、文档注释
+/// @param state
+static void test_lex_literals_and_comments(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    const char* src =
+        "/// outer doc\n"
+        "/* plain /* nested */ still comment */\n"
+        "'a 'x' b'\\n' \"s\\\"q\" r##\"raw \"# str\"## br\"b\" c\"c\" 0x1F_u32 1.5e3f64 7\n"
+        "// dropped\n";
+    TokenStream ts;
+    assert_int_equal(lexer_tokenize(src, strlen(src), &ts), 0);
+
+    const TokenKind kinds[] = {
+        Tk_DocComment, Tk_Lifetime, Tk_Literal, Tk_Literal, Tk_Literal, Tk_Literal,
+        Tk_Literal, Tk_Literal, Tk_Literal, Tk_Literal, Tk_Literal, Tk_Eof,
+    };
+    assert_kinds(&ts, kinds, sizeof(kinds) / sizeof(kinds[0]));
+
+    Token* t = ts.head;
+    assert_string_equal(symbol_str(t->data.doc_comment.symbol), " outer doc");
+    t = t->next;
+    assert_string_equal(symbol_str(t->data.ident.symbol), "'a");
+
+    const LitKind lits[] = {
+        LIT_CHAR, LIT_BYTE, LIT_STR, LIT_STR_RAW, LIT_BYTE_STR_RAW, LIT_CSTR, LIT_INTEGER, LIT_FLOAT, LIT_INTEGER,
+    };
+    const Literal* l[9];
+    t = t->next;
+    for (size_t i = 0; i < 9; i++, t = t->next) {
+        l[i] = token_literal(t);
+        assert_non_null(l[i]);
+        assert_int_equal(l[i]->kind, lits[i]);
+    }
+    assert_int_equal(l[0]->as.char_val, 'x');
+    assert_int_equal(l[1]->as.byte_val, '\n');
+    assert_string_equal(symbol_str(l[2]->symbol), "s\\\"q");
+    assert_string_equal(symbol_str(l[3]->symbol), "raw \"# str");
+    assert_int_equal(l[3]->as.raw_str.num_hashes, 2);
+    assert_int_equal(l[6]->as.int_val, 0x1F);
+    assert_string_equal(symbol_str(l[6]->suffix), "u32");
+    assert_true(l[7]->as.float_val == 1.5e3);
+    assert_string_equal(symbol_str(l[7]->suffix), "f64");
+    assert_int_equal(l[8]->as.int_val, 7);
+
+    token_stream_free(&ts);
+    token_pool_cleanup();
+}
+// ==============================================================
+/// @brief 异常场景::未闭合的字符串与块注释
+/// @param state
+static void test_lex_errors(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    const char* cases[] = { "x \"abc", "x /* /* */", "x 0b", "x \x01" };
+    const uint32_t codes[] = {
+        LEX_ERR_UNTERMINATED_STR, LEX_ERR_UNTERMINATED_COMMENT, LEX_ERR_INVALID_NUMBER, LEX_ERR_UNKNOWN_CHAR,
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        TokenStream ts;
+        assert_int_equal(lexer_tokenize(cases[i], strlen(cases[i]), &ts), 1);
+        Token* err = ts.head->next;
+        assert_int_equal(err->type, Tk_Error);
+        assert_int_equal(token_literal(err)->as.error.error_code, codes[i]);
+        assert_int_equal(ts.tail->type, Tk_Eof);
+        token_stream_free(&ts);
+    }
+    token_pool_cleanup();
+}
+// ==============================================================
+/// @brief 并行词法分析::跨接缝的字符串/注释触发重做，结果与串行一致
+/// @param state
+static char* build_corpus(size_t target, size_t* out_len) {
+    static const char* snippets[] = {
+        "fn f(a: u32) -> u32 { a + 1 }\n",
+        "let s = \"multi\nline\nstring\";\n",
+        "/* block\ncomment /* nested\n */ */\n",
+        "let r = r#\"raw\n\"quoted\"\n\"#;\n",
+        "/// doc line\nstruct S { x: f64 }\n",
+        "let v = [1.5e3, 0x_ff, 'c', b'\\n'];\n",
+    };
+    size_t cap = target + 256;
+    char* buf = malloc(cap);
+    size_t len = 0;
+    for (size_t i = 0; len < target; i++) {
+        const char* s = snippets[(i * 7) % (sizeof(snippets) / sizeof(snippets[0]))];
+        size_t n = strlen(s);
+        memcpy(buf + len, s, n);
+        len += n;
+    }
+    *out_len = len;
+    return buf;
+}
+
+static void test_lex_parallel(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    size_t len = 0;
+    char* src = build_corpus(LEXER_PAR_MIN_CHUNK * 8, &len);
+
+    TokenStream seq, par;
+    size_t seq_err = lexer_tokenize(src, len, &seq);
+    for (size_t threads = 2; threads <= 8; threads *= 2) {
+        size_t par_err = lexer_tokenize_parallel(src, len, threads, &par);
+        assert_int_equal(seq_err, par_err);
+        assert_streams_equal(&seq, &par);
+        token_stream_free(&par);
+    }
+
+    // 未闭合的块注释吞掉后续全部分块
+    memcpy(src + len / 3, "/*", 2);
+    seq_err = lexer_tokenize(src, len, &par);
+    TokenStream par2;
+    assert_int_equal(lexer_tokenize_parallel(src, len, 4, &par2), seq_err);
+    assert_streams_equal(&par, &par2);
+
+    token_stream_free(&par);
+    token_stream_free(&par2);
+    token_stream_free(&seq);
+    free(src);
+    token_pool_cleanup();
+}
+
+// ==============================================================
+/// @brief 增量重分析::局部编辑后与全量分析结果一致，且仅重做少量Token
+/// @param state
+static char* apply_edit(const char* src, size_t len, const TextEdit* e, const char* text, size_t* out_len) {
+    size_t n = len - e->removed + e->inserted;
+    char* buf = malloc(n + 1);
+    memcpy(buf, src, e->offset);
+    memcpy(buf + e->offset, text, e->inserted);
+    memcpy(buf + e->offset + e->inserted, src + e->offset + e->removed, len - e->offset - e->removed);
+    buf[n] = '\0';
+    *out_len = n;
+    return buf;
+}
+
+static void test_lex_incremental(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    size_t len = 0;
+    char* src = build_corpus(1 << 16, &len);
+    TokenStream ts;
+    lexer_tokenize(src, len, &ts);
+
+    // 依次施加：标识符内插入、插入空白、删除、打开字符串、闭合字符串、打开块注释、删除注释、
+    // 插入与删去未闭合的`{`、类型不符的`(]`（配对须与整体重分析一致）
+    // 局部编辑只重做少量Token；字符串奇偶翻转会一直影响到文件末尾，不设上限
+    struct { size_t offset; size_t removed; const char* text; size_t max_relexed; } edits[] = {
+        { 3,         0, "oo",  4 },
+        { len / 2,   0, " ",   4 },
+        { 1000,      4, "",    4 },
+        { 200,       0, "\"", SIZE_MAX },
+        { 200,       0, "\"", SIZE_MAX },
+        { len / 3,   0, "/*",  SIZE_MAX },
+        { len / 3,   2, "",    SIZE_MAX },
+        { len / 4,   0, "{",   4 },
+        { len / 4,   1, "",    4 },
+        { len / 5,   0, "(]",  6 },
+        { len / 5,   2, "",    6 },
+    };
+    for (size_t i = 0; i < sizeof(edits) / sizeof(edits[0]); i++) {
+        TextEdit e = { edits[i].offset, edits[i].removed, strlen(edits[i].text) };
+        size_t new_len = 0;
+        char* next = apply_edit(src, len, &e, edits[i].text, &new_len);
+        free(src);
+        src = next;
+        len = new_len;
+
+        size_t relexed = lexer_relex(&ts, src, len, &e);
+        assert_true(relexed <= edits[i].max_relexed);
+
+        TokenStream full;
+        lexer_tokenize(src, len, &full);
+        assert_streams_equal(&ts, &full);
+        token_stream_free(&full);
+    }
+
+    token_stream_free(&ts);
+    free(src);
+
+    // 指数探测越过任意多个`_`：`1e+___`末尾补上数字后`1`须一并重分析
+    char exp_src[] = "1e+___1";
+    TokenStream exp_ts;
+    lexer_tokenize(exp_src, 6, &exp_ts);
+    TextEdit exp_edit = { 6, 0, 1 };
+    lexer_relex(&exp_ts, exp_src, 7, &exp_edit);
+    TokenStream exp_full;
+    lexer_tokenize(exp_src, 7, &exp_full);
+    assert_int_equal(exp_full.head->span.len, 7);
+    assert_streams_equal(&exp_ts, &exp_full);
+    token_stream_free(&exp_full);
+    token_stream_free(&exp_ts);
+    token_pool_cleanup();
+}
+
+// ==============================================================
+/// @brief 全局Span::多文件地址区间、文件/行/列解析与带基址的增量重分析
+/// @param state
+static void test_lex_source_map(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    const char* a = "fn a() {}\n";
+    const char* b = "let x = 1;\n  let y = \"s\";";
+    SourceMap map;
+    source_map_init(&map);
+    const SourceFile* fa = source_map_add(&map, "a.rs", a, strlen(a));
+    const SourceFile* fb = source_map_add(&map, "b.rs", b, strlen(b));
+    assert_non_null(fa);
+    assert_non_null(fb);
+    assert_true(fb->base > fa->base + fa->len);
+
+    TokenStream ta, tb;
+    assert_int_equal(lexer_tokenize_file(fa, &ta), 0);
+    assert_int_equal(lexer_tokenize_file(fb, &tb), 0);
+    // 文件a的Eof仍归属a，文件b的所有Span都在a之后
+    SourceLoc loc;
+    assert_true(source_map_lookup(&map, ta.tail->span.lo, &loc));
+    assert_ptr_equal(loc.file, fa);
+    assert_true(SPAN_KEY(ta.tail->span) < SPAN_KEY(tb.head->span));
+
+    // `y`位于b.rs第2行第7列
+    const Token* y = tb.head;
+    for (int i = 0; i < 6; i++) y = y->next;
+    assert_string_equal(symbol_str(y->data.ident.symbol), "y");
+    assert_true(source_map_lookup(&map, y->span.lo, &loc));
+    assert_ptr_equal(loc.file, fb);
+    assert_string_equal(loc.file->name, "b.rs");
+    assert_int_equal(loc.line, 2);
+    assert_int_equal(loc.column, 7);
+    assert_int_equal(y->span.len, 1);
+    assert_false(source_map_lookup(&map, fb->base + fb->len + 1, &loc));
+    assert_ptr_equal(source_map_file(&map, fa->base + fa->len), fa);
+    assert_ptr_equal(source_map_file(&map, fa->base + fa->len + 1), fb);
+
+    // 基址非零的流同样可增量重分析
+    const char* b2 = "let xx = 1;\n  let y = \"s\";";
+    TextEdit e = { 5, 0, 1 };
+    lexer_relex(&tb, b2, strlen(b2), &e);
+    TokenStream full;
+    SourceFile f2 = *fb;
+    f2.src = b2;
+    f2.len = (uint32_t)strlen(b2);
+    lexer_tokenize_file(&f2, &full);
+    assert_streams_equal(&tb, &full);
+
+    token_stream_free(&full);
+    token_stream_free(&ta);
+    token_stream_free(&tb);
+    source_map_destroy(&map);
+    token_pool_cleanup();
+}
+
+// ==============================================================
+/// @brief 数值字面量::延迟解码、SWAR整数与快速浮点路径、后缀范围
+/// @param state
+static void test_lex_numeric_decode(void **state) {
+    MACRO_UNUSED(state);
+    struct { const char* s; LitState st; uint64_t v; } ints[] = {
+        { "0",                     LIT_STATE_OK,       0 },
+        { "12345678",              LIT_STATE_OK,       12345678 },
+        { "123456789012",          LIT_STATE_OK,       123456789012ULL },
+        { "1_000_000",             LIT_STATE_OK,       1000000 },
+        { "1234_5678_9012_3456",   LIT_STATE_OK,       1234567890123456ULL },
+        { "18446744073709551615",  LIT_STATE_OK,       UINT64_MAX },
+        { "18446744073709551616",  LIT_STATE_OVERFLOW, 0 },
+        { "0xFFFF_ffff",           LIT_STATE_OK,       0xFFFFFFFFULL },
+        { "0b1010",                LIT_STATE_OK,       10 },
+        { "0o777",                 LIT_STATE_OK,       0777 },
+        { "0x1_0000_0000_0000_0000", LIT_STATE_OVERFLOW, 0 },
+        { "12a",                   LIT_STATE_INVALID,  0 },
+    };
+    for (size_t i = 0; i < sizeof(ints) / sizeof(ints[0]); i++) {
+        uint64_t v = 0;
+        assert_int_equal(lit_parse_int(ints[i].s, strlen(ints[i].s), &v), ints[i].st);
+        if (ints[i].st == LIT_STATE_OK) assert_true(v == ints[i].v);
+    }
+
+    // 快速路径与回退路径均须与strtod/strtof逐位一致
+    const char* floats[] = {
+        "1.5", "0.1", "3.141592653589793", "1e22", "1e23", "2.5e-3", "123456789.125",
+        "9007199254740993.0", "0.000001", "1_000.000_1", "12345678901234567890.5",
+        "1e-320", "1.7976931348623157e308", "4.9e-324", "0.3e10",
+    };
+    for (size_t i = 0; i < sizeof(floats) / sizeof(floats[0]); i++) {
+        char buf[64];
+        size_t k = 0;
+        for (const char* c = floats[i]; *c; c++) {
+            if (*c != '_') buf[k++] = *c;
+        }
+        buf[k] = '\0';
+        double d = 0.0;
+        assert_int_equal(lit_parse_float(floats[i], strlen(floats[i]), false, &d), LIT_STATE_OK);
+        assert_true(d == strtod(buf, NULL));
+        assert_int_not_equal(lit_parse_float(floats[i], strlen(floats[i]), true, &d), LIT_STATE_INVALID);
+        assert_true((float)d == strtof(buf, NULL));
+    }
+
+    // 词法阶段只记录原文，首次访问时解码并校验后缀范围
+    token_pool_init(TOKEN_POOL_BLOCK);
+    const char* src = "255u8 256u8 128i8 4294967295u32 1.1f32 1.1 7";
+    TokenStream ts;
+    assert_int_equal(lexer_tokenize(src, strlen(src), &ts), 0);
+    const LitState states[] = {
+        LIT_STATE_OK, LIT_STATE_OVERFLOW, LIT_STATE_OK, LIT_STATE_OK, LIT_STATE_OK, LIT_STATE_OK, LIT_STATE_OK,
+    };
+    Token* t = ts.head;
+    for (size_t i = 0; i < sizeof(states) / sizeof(states[0]); i++, t = t->next) {
+        assert_int_equal(literal_table_get(t->data.literal)->state, LIT_STATE_PENDING);
+        const Literal* lit = token_literal(t);
+        assert_int_equal(lit->state, states[i]);
+    }
+    t = ts.head;
+    assert_int_equal(token_literal(t)->as.int_val, 255);
+    assert_int_equal(token_literal(t->next->next->next)->as.int_val, 4294967295LL);
+    assert_true(token_literal(t->next->next->next->next)->as.float_val == (double)1.1f);
+    assert_true(token_literal(t->next->next->next->next->next)->as.float_val == 1.1);
+    token_stream_free(&ts);
+
+    // 十进制整数带f32/f64后缀按浮点解码；`0x1f32`的f32是十六进制数字
+    const char* fsrc = "1f32 2f64 0x1f32 3f16";
+    assert_int_equal(lexer_tokenize(fsrc, strlen(fsrc), &ts), 0);
+    t = ts.head;
+    assert_int_equal(token_literal(t)->kind, LIT_FLOAT);
+    assert_int_equal(token_literal(t)->state, LIT_STATE_OK);
+    assert_true(token_literal(t)->as.float_val == 1.0);
+    assert_int_equal(token_literal(t->next)->kind, LIT_FLOAT);
+    assert_true(token_literal(t->next)->as.float_val == 2.0);
+    assert_int_equal(token_literal(t->next->next)->kind, LIT_INTEGER);
+    assert_int_equal(token_literal(t->next->next)->as.int_val, 0x1f32);
+    assert_int_equal(token_literal(t->next->next->next)->kind, LIT_INTEGER);
+    assert_int_equal(token_literal(t->next->next->next)->as.int_val, 3);
+
+    token_stream_free(&ts);
+    token_pool_cleanup();
+}
+
+// ==============================================================
+/// @brief 性能测试::数值密集语料的词法分析与字面量解码
+/// @param state
+#define NUMERIC_BENCH_LITERALS  (1 << 18)
+#define NUMERIC_BENCH_DISTINCT  512
+
+static double bench_secs(const struct timespec* t0, const struct timespec* t1) {
+    return (t1->tv_sec - t0->tv_sec) + (t1->tv_nsec - t0->tv_nsec) * 1e-9;
+}
+
+static void benchmark_numeric_literals(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+
+    // 生成表格式数值语料：整数、带分隔符整数、浮点各占一部分
+    char distinct[NUMERIC_BENCH_DISTINCT][40];
+    srand(42);
+    for (int i = 0; i < NUMERIC_BENCH_DISTINCT; i++) {
+        unsigned long long a = ((unsigned long long)rand() << 31) ^ (unsigned long long)rand();
+        switch (i % 4) {
+            case 0:  snprintf(distinct[i], sizeof(distinct[i]), "%llu", a % 100000); break;
+            case 1:  snprintf(distinct[i], sizeof(distinct[i]), "%lluu64", a); break;
+            case 2:  snprintf(distinct[i], sizeof(distinct[i]), "%llu.%03d", a % 1000000, rand() % 1000); break;
+            default: snprintf(distinct[i], sizeof(distinct[i]), "%d.%de-%df32", rand() % 100, rand() % 100, rand() % 8); break;
+        }
+    }
+    size_t cap = (size_t)NUMERIC_BENCH_LITERALS * 42;
+    char* src = malloc(cap);
+    size_t len = 0;
+    for (int i = 0; i < NUMERIC_BENCH_LITERALS; i++) {
+        len += (size_t)snprintf(src + len, cap - len, "%s,", distinct[(i * 7919) % NUMERIC_BENCH_DISTINCT]);
+    }
+
+    struct timespec t0, t1, t2;
+    TokenStream ts;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    lexer_tokenize(src, len, &ts);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double sum = 0.0;
+    for (Token* t = ts.head; t; t = t->next) {
+        if (t->type != Tk_Literal) continue;
+        const Literal* lit = token_literal(t);
+        sum += lit->kind == LIT_FLOAT ? lit->as.float_val : (double)lit->as.int_val;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    printf("[Numeric] lex (lazy): %.2f Mtok/sec, first decode: %.2f Mlit/sec\n",
+        ts.count / bench_secs(&t0, &t1) / 1e6, NUMERIC_BENCH_LITERALS / bench_secs(&t1, &t2) / 1e6);
+
+    // 纯解析器对比：SWAR/快速路径 vs strtoull/strtod
+    const int rounds = 64;
+    volatile double sink = sum;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < NUMERIC_BENCH_DISTINCT; i++) {
+            const char* s = distinct[i];
+            size_t n = strcspn(s, "uf");
+            double d = 0.0;
+            uint64_t v = 0;
+            if (memchr(s, '.', n)) {
+                lit_parse_float(s, n, false, &d);
+            } else {
+                lit_parse_int(s, n, &v);
+                d = (double)v;
+            }
+            sink += d;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < NUMERIC_BENCH_DISTINCT; i++) {
+            const char* s = distinct[i];
+            size_t n = strcspn(s, "uf");
+            char buf[40];
+            memcpy(buf, s, n);
+            buf[n] = '\0';
+            sink += memchr(s, '.', n) ? strtod(buf, NULL) : (double)strtoull(buf, NULL, 10);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    double ops = (double)rounds * NUMERIC_BENCH_DISTINCT;
+    printf("[Numeric] lit_parse: %.2f Mops/sec, libc: %.2f Mops/sec\n",
+        ops / bench_secs(&t0, &t1) / 1e6, ops / bench_secs(&t1, &t2) / 1e6);
+    (void)sink;
+
+    token_stream_free(&ts);
+    free(src);
+    token_pool_cleanup();
+}
+
+
+// ==============================================================
+/// @brief 字符串扫描::向量化查找与逐字节参考实现一致（奇偶反斜杠、跨块、`#`串）
+/// @param state
+static size_t ref_scan_quoted(const char* s, size_t len, size_t p, bool* esc) {
+    *esc = false;
+    while (p < len) {
+        if (s[p] == '\\') {
+            *esc = true;
+            p += 2;
+            continue;
+        }
+        if (s[p] == '"') return p;
+        p++;
+    }
+    return len;
+}
+
+static size_t ref_scan_raw_close(const char* s, size_t len, size_t p, size_t hashes) {
+    for (; p < len; p++) {
+        if (s[p] != '"') continue;
+        size_t h = 0;
+        while (h < hashes && p + 1 + h < len && s[p + 1 + h] == '#') h++;
+        if (h == hashes) return p;
+    }
+    return len;
+}
+
+static void test_lex_string_scan(void **state) {
+    MACRO_UNUSED(state);
+    const char alphabet[] = { 'a', '\\', '\\', '"', '#', '#', 'x', ' ' };
+    char buf[300];
+    srand(7);
+    for (int iter = 0; iter < 2000; iter++) {
+        size_t len = (size_t)(rand() % (int)sizeof(buf));
+        for (size_t i = 0; i < len; i++) buf[i] = alphabet[rand() % (int)sizeof(alphabet)];
+        size_t p = len ? (size_t)(rand() % (int)len) : 0;
+
+        bool e1 = false, e2 = false;
+        size_t want = ref_scan_quoted(buf, len, p, &e1);
+        assert_int_equal(scan_quoted(buf, len, p, &e2), LEX_MIN(want, len));
+        assert_int_equal(e1, e2);
+
+        size_t hashes = (size_t)(rand() % 4);
+        assert_int_equal(scan_raw_close(buf, len, p, hashes), ref_scan_raw_close(buf, len, p, hashes));
+    }
+
+    // 无转义字符串与原始字符串零拷贝引用源码，首次访问时内部化
+    token_pool_init(TOKEN_POOL_BLOCK);
+    const char* src = "\"plain\" \"esc\\n\" r##\"raw\"##";
+    TokenStream ts;
+    assert_int_equal(lexer_tokenize(src, strlen(src), &ts), 0);
+    const Literal* plain = literal_table_get(ts.head->data.literal);
+    const Literal* esc = literal_table_get(ts.head->next->data.literal);
+    const Literal* raw = literal_table_get(ts.head->next->next->data.literal);
+    assert_int_equal(plain->state, LIT_STATE_PENDING);
+    assert_ptr_equal(plain->as.str.ptr, src + 1);
+    assert_int_equal(esc->state, LIT_STATE_OK);
+    assert_ptr_equal(raw->as.raw_str.ptr, src + 20);
+    assert_string_equal(symbol_str(token_literal(ts.head)->symbol), "plain");
+    assert_string_equal(symbol_str(token_literal(ts.head->next->next)->symbol), "raw");
+    assert_int_equal(plain->state, LIT_STATE_OK);
+    token_stream_free(&ts);
+    token_pool_cleanup();
+}
+
+// ==============================================================
+/// @brief 性能测试::字符串密集语料的扫描吞吐
+/// @param state
+static void benchmark_string_scan(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    static const char* snippets[] = {
+        "let msg = \"a reasonably long message without any escapes in it at all\";\n",
+        "let esc = \"tab\\there \\\"quoted\\\" and a trailing backslash \\\\\";\n",
+        "let raw = r#\"raw text with \"inner\" quotes and #hashes\"#;\n",
+        "let bytes = b\"\\x00\\x01binary-ish payload\";\n",
+    };
+    size_t target = 8u << 20;
+    char* src = malloc(target + 256);
+    size_t len = 0;
+    for (size_t i = 0; len < target; i++) {
+        const char* s = snippets[i % 4];
+        size_t n = strlen(s);
+        memcpy(src + len, s, n);
+        len += n;
+    }
+
+    struct timespec t0, t1, t2;
+    size_t vec_hits = 0, ref_hits = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (size_t p = 0; p < len; p++) {
+        if (src[p] != '"') continue;
+        bool e = false;
+        p = scan_quoted(src, len, p + 1, &e);
+        vec_hits++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (size_t p = 0; p < len; p++) {
+        if (src[p] != '"') continue;
+        bool e = false;
+        p = ref_scan_quoted(src, len, p + 1, &e);
+        ref_hits++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    assert_int_equal(vec_hits, ref_hits);
+    double mb = len / (1024.0 * 1024.0);
+    printf("[String scan] vector: %.2f MB/sec, byte loop: %.2f MB/sec\n",
+        mb / bench_secs(&t0, &t1), mb / bench_secs(&t1, &t2));
+
+    TokenStream ts;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    lexer_tokenize(src, len, &ts);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("[String scan] lexer_tokenize: %.2f MB/sec (%zu tokens)\n", mb / bench_secs(&t0, &t1), ts.count);
+
+    token_stream_free(&ts);
+    free(src);
+    token_pool_cleanup();
+}
+
+
+// ==============================================================
+/// @brief 注释扫描::向量化块注释嵌套匹配与逐字节参考实现一致；普通注释不产生Token与分配
+/// @param state
+static size_t ref_scan_block_comment(const char* s, size_t len, size_t p) {
+    size_t depth = 1;
+    while (p + 1 < len) {
+        if (s[p] == '/' && s[p + 1] == '*') {
+            depth++;
+            p += 2;
+        } else if (s[p] == '*' && s[p + 1] == '/') {
+            if (--depth == 0) return p + 2;
+            p += 2;
+        } else {
+            p++;
+        }
+    }
+    return SIZE_MAX;
+}
+
+static void test_lex_comment_scan(void **state) {
+    MACRO_UNUSED(state);
+    const char alphabet[] = { '/', '*', '/', '*', 'a', ' ', '\n' };
+    char buf[400];
+    srand(11);
+    for (int iter = 0; iter < 4000; iter++) {
+        size_t len = (size_t)(rand() % (int)sizeof(buf));
+        for (size_t i = 0; i < len; i++) buf[i] = alphabet[rand() % (int)sizeof(alphabet)];
+        size_t p = len ? (size_t)(rand() % (int)len) : 0;
+        assert_int_equal(scan_block_comment(buf, len, p), ref_scan_block_comment(buf, len, p));
+        const char* nl = memchr(buf + p, '\n', len - p);
+        assert_int_equal(scan_line_end(buf, len, p), nl ? (size_t)(nl - buf) : len);
+    }
+
+    token_pool_init(TOKEN_POOL_BLOCK);
+    const char* src =
+        "// license line one\n"
+        "//// not a doc comment\n"
+        "/* block /* nested */ with *stars* and /slashes/ */\n"
+        "/**/ /***/\n"
+        "x /*/ still open */ y\n";
+    size_t literals = test_get_literal_count();
+    TokenStream ts;
+    assert_int_equal(lexer_tokenize(src, strlen(src), &ts), 0);
+    const TokenKind kinds[] = { Tk_Ident, Tk_Ident, Tk_Eof };
+    assert_kinds(&ts, kinds, sizeof(kinds) / sizeof(kinds[0]));
+    TokenPoolStats stats;
+    token_pool_stats(&stats);
+    assert_int_equal(stats.in_use, 3);
+    assert_int_equal(test_get_literal_count(), literals);
+    token_stream_free(&ts);
+    token_pool_cleanup();
+}
+
+// ==============================================================
+/// @brief 性能测试::注释密集语料（许可证头与生成的文档块）
+/// @param state
+static void benchmark_comment_skip(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    static const char* snippets[] = {
+        "// Copyright (c) 2025 The North Authors. All rights reserved.\n"
+        "// Licensed under the Apache License, Version 2.0 (the \"License\");\n"
+        "// you may not use this file except in compliance with the License.\n",
+        "/*\n * Generated by a table builder; do not edit by hand.\n"
+        " * /* nested region marker */ regenerate with the build script.\n */\n",
+        "fn item() {}\n",
+    };
+    size_t target = 8u << 20;
+    char* src = malloc(target + 512);
+    size_t len = 0;
+    for (size_t i = 0; len < target; i++) {
+        const char* s = snippets[i % 3];
+        size_t n = strlen(s);
+        memcpy(src + len, s, n);
+        len += n;
+    }
+
+    struct timespec t0, t1, t2;
+    size_t vec_end = 0, ref_end = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (size_t p = 0; p + 1 < len; p++) {
+        if (src[p] == '/' && src[p + 1] == '*') p = vec_end = scan_block_comment(src, len, p + 2);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (size_t p = 0; p + 1 < len; p++) {
+        if (src[p] == '/' && src[p + 1] == '*') p = ref_end = ref_scan_block_comment(src, len, p + 2);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    assert_int_equal(vec_end, ref_end);
+    double mb = len / (1024.0 * 1024.0);
+    printf("[Comment skip] block comments vector: %.2f MB/sec, byte loop: %.2f MB/sec\n",
+        mb / bench_secs(&t0, &t1), mb / bench_secs(&t1, &t2));
+
+    TokenStream ts;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    lexer_tokenize(src, len, &ts);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("[Comment skip] lexer_tokenize: %.2f MB/sec (%zu tokens)\n", mb / bench_secs(&t0, &t1), ts.count);
+
+    token_stream_free(&ts);
+    free(src);
+    token_pool_cleanup();
+}
+
+
+typedef struct RingBench {
+    TokenRing* ring;
+    Token* token;
+    size_t ops;
+} RingBench;
+
+static void* ring_bench_producer(void* arg) {
+    RingBench* rb = arg;
+    for (size_t i = 0; i < rb->ops; i++) token_ring_push(rb->ring, rb->token);
+    token_ring_close(rb->ring);
+    return NULL;
+}
+
+// ==============================================================
+/// @brief 流水线::词法线程经SPSC环交付的Token与串行结果一致，peek_token可向前查看
+/// @param state
+static void test_lex_pipeline(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    size_t len = 0;
+    char* src = build_corpus(1 << 18, &len);
+    TokenStream seq;
+    size_t seq_err = lexer_tokenize(src, len, &seq);
+
+    // 最小容量下频繁触发满/空等待
+    const size_t capacities[] = { 1, TOKEN_RING_DEFAULT };
+    for (size_t c = 0; c < sizeof(capacities) / sizeof(capacities[0]); c++) {
+        TokenPipe pipe;
+        assert_int_equal(token_pipe_start(&pipe, src, len, capacities[c]), 0);
+        size_t n = 0;
+        for (const Token* want = seq.head; want; want = want->next, n++) {
+            if (n % 97 == 0) {
+                Token* ahead = peek_token(&pipe, 5);
+                const Token* w5 = want;
+                for (int k = 0; k < 5 && w5; k++) w5 = w5->next;
+                if (w5) {
+                    assert_non_null(ahead);
+                    assert_int_equal(ahead->span.lo, w5->span.lo);
+                } else {
+                    assert_null(ahead);
+                }
+            }
+            Token* got = next_token(&pipe);
+            assert_non_null(got);
+            assert_int_equal(got->type, want->type);
+            assert_int_equal(SPAN_KEY(got->span), SPAN_KEY(want->span));
+            token_free(got);
+        }
+        assert_null(next_token(&pipe));
+        assert_int_equal(token_pipe_finish(&pipe), seq_err);
+    }
+
+    // 消费者中途放弃
+    TokenPipe pipe;
+    assert_int_equal(token_pipe_start(&pipe, src, len, 256), 0);
+    for (int i = 0; i < 1000; i++) token_free(next_token(&pipe));
+    token_pipe_finish(&pipe);
+    TokenPoolStats stats;
+    token_pool_stats(&stats);
+    // 弹匣回收下本线程弹匣中的空闲Token计入使用中：先以不释放任何块的修剪交回仓库
+    token_pool_trim(stats.resident);
+    token_pool_stats(&stats);
+    assert_int_equal(stats.in_use, seq.count);
+
+    token_stream_free(&seq);
+    free(src);
+    token_pool_cleanup();
+}
+
+// ==============================================================
+/// @brief 性能测试::串行 词法+消费 vs 流水线
+/// @param state
+static void benchmark_lex_pipeline(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    size_t len = 0;
+    char* src = build_corpus(8u << 20, &len);
+    struct timespec t0, t1, t2;
+
+    // 以累加Span模拟语法分析的逐Token工作
+    size_t work = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    Lexer lexer;
+    lexer_init(&lexer, src, len);
+    Token* t;
+    while ((t = lexer_next(&lexer))) {
+        work += (size_t)t->span.lo ^ (size_t)t->type;
+        token_free(t);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    TokenPipe pipe;
+    token_pipe_start(&pipe, src, len, TOKEN_RING_DEFAULT);
+    size_t piped = 0;
+    while ((t = next_token(&pipe))) {
+        piped += t->type == Tk_Eof ? 0 : (size_t)t->span.lo ^ (size_t)t->type;
+        token_free(t);
+    }
+    token_pipe_finish(&pipe);
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    assert_int_equal(work, piped);
+
+    double mb = len / (1024.0 * 1024.0);
+    printf("[Pipeline] serial: %.2f MB/sec, lexer thread + SPSC ring: %.2f MB/sec\n",
+        mb / bench_secs(&t0, &t1), mb / bench_secs(&t1, &t2));
+
+    // 纯环吞吐：生产者推送同一指针
+    TokenRing ring;
+    token_ring_init(&ring, TOKEN_RING_DEFAULT);
+    const size_t ops = 1u << 24;
+    Token* dummy = token_alloc(Tk_Ident, (Span){0, 0});
+    pthread_t producer;
+    RingBench rb = { &ring, dummy, ops };
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    pthread_create(&producer, NULL, ring_bench_producer, &rb);
+    size_t got = 0;
+    while (token_ring_pop(&ring)) got++;
+    pthread_join(producer, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    assert_int_equal(got, ops);
+    printf("[Pipeline] SPSC ring: %.2f Mops/sec\n", ops / bench_secs(&t0, &t1) / 1e6);
+    free(ring.slots);
+    token_free(dummy);
+
+    free(src);
+    token_pool_cleanup();
+}
+
+
+// ==============================================================
+/// @brief 分隔符配对::嵌套、类型不符与未闭合，跳过整个分组
+/// @param state
+static const Token* nth_token(const TokenStream* ts, size_t n) {
+    const Token* t = ts->head;
+    while (n--) t = t->next;
+    return t;
+}
+
+static void test_lex_delim_match(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    //                 0  1 2 3 4 5 6 7 8 9 10 11
+    const char* src = "f ( [ { } ] ) ( ] ) { (";
+    TokenStream ts;
+    lexer_tokenize(src, strlen(src), &ts);
+    const size_t pairs[][2] = { {1, 6}, {2, 5}, {3, 4}, {7, 9} };
+    for (size_t i = 0; i < sizeof(pairs) / sizeof(pairs[0]); i++) {
+        const Token* open = nth_token(&ts, pairs[i][0]);
+        const Token* close = nth_token(&ts, pairs[i][1]);
+        assert_ptr_equal(open->data.delim.match, close);
+        assert_ptr_equal(close->data.delim.match, open);
+    }
+    // `]`在`(`内部找不到`[`：不配对；结尾的`{ (`未闭合
+    assert_null(nth_token(&ts, 8)->data.delim.match);
+    assert_null(nth_token(&ts, 10)->data.delim.match);
+    assert_null(nth_token(&ts, 11)->data.delim.match);
+    assert_ptr_equal(token_skip_group(nth_token(&ts, 1)), nth_token(&ts, 7));
+    assert_null(token_skip_group(nth_token(&ts, 10)));
+    token_stream_free(&ts);
+
+    // 深度超过内联栈
+    char deep[1024];
+    size_t n = 0;
+    for (int i = 0; i < 300; i++) deep[n++] = '[';
+    for (int i = 0; i < 300; i++) deep[n++] = ']';
+    lexer_tokenize(deep, n, &ts);
+    for (size_t i = 0; i < 300; i++) {
+        assert_ptr_equal(nth_token(&ts, i)->data.delim.match, nth_token(&ts, 599 - i));
+    }
+    token_stream_free(&ts);
+
+    // 增量重分析：删去一个`{`后远处的配对随之改变
+    const char* a = "fn f() { g(); { h(); } }";
+    lexer_tokenize(a, strlen(a), &ts);
+    const char* b = "fn f() { g();  h(); } }";
+    TextEdit e = { 14, 1, 0 };
+    lexer_relex(&ts, b, strlen(b), &e);
+    TokenStream full;
+    lexer_tokenize(b, strlen(b), &full);
+    assert_streams_equal(&ts, &full);
+    // `fn f ( ) {`的`{`改与倒数第二个`}`配对，最后一个`}`未配对
+    assert_ptr_equal(nth_token(&ts, 4)->data.delim.match, nth_token(&ts, ts.count - 3));
+    assert_null(nth_token(&ts, ts.count - 2)->data.delim.match);
+    token_stream_free(&full);
+    token_stream_free(&ts);
+    token_pool_cleanup();
+}
+
+/// @brief 分隔符配对::跳过函数体与逐Token遍历的对比
+/// @param state
+static void benchmark_delim_skip(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    size_t len = 0;
+    char* src = build_corpus(8 << 20, &len);
+    // 每32行包进一个函数体，模拟惰性解析时只扫描条目头
+    size_t cap = len + len / 8 + 64;
+    char* buf = malloc(cap);
+    size_t n = 0;
+    for (size_t i = 0; i < len; ) {
+        size_t end = i;
+        for (int k = 0; k < 32 && end < len; k++) {
+            const char* nl = memchr(src + end, '\n', len - end);
+            end = nl ? (size_t)(nl - src) + 1 : len;
+        }
+        n += (size_t)snprintf(buf + n, cap - n, "fn f() {\n%.*s}\n", (int)(end - i), src + i);
+        i = end;
+    }
+
+    TokenStream ts;
+    lexer_tokenize(buf, n, &ts);
+    size_t walked = 0, items = 0;
+    struct timespec t0, t1, t2;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (const Token* t = ts.head; t; t = t->next) walked++;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (const Token* t = ts.head; t; ) {
+        const Token* skip = t->type == Tk_OpenDelim && t->data.delim.delim == DELIM_BRACE ? token_skip_group(t) : NULL;
+        t = skip ? skip : t->next;
+        items++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    assert_true(items < walked);
+    printf("[Delim] %zu tokens walked: %.2f ms, %zu visited with body skip: %.2f ms\n",
+           walked, bench_secs(&t0, &t1) * 1e3, items, bench_secs(&t1, &t2) * 1e3);
+
+    token_stream_free(&ts);
+    free(buf);
+    free(src);
+    token_pool_cleanup();
+}
+
+void entry_lexer(void** state) {
+    MACRO_UNUSED(state);
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_lex_basic),
+        cmocka_unit_test(test_lex_literals_and_comments),
+        cmocka_unit_test(test_lex_errors),
+        cmocka_unit_test(test_lex_parallel),
+        cmocka_unit_test(test_lex_incremental),
+        cmocka_unit_test(test_lex_source_map),
+        cmocka_unit_test(test_lex_numeric_decode),
+        cmocka_unit_test(benchmark_numeric_literals),
+        cmocka_unit_test(test_lex_string_scan),
+        cmocka_unit_test(benchmark_string_scan),
+        cmocka_unit_test(test_lex_comment_scan),
+        cmocka_unit_test(benchmark_comment_skip),
+        cmocka_unit_test(test_lex_pipeline),
+        cmocka_unit_test(benchmark_lex_pipeline),
+        cmocka_unit_test(test_lex_delim_match),
+        cmocka_unit_test(benchmark_delim_skip),
+    };
+    cmocka_run_group_tests(tests, NULL, NULL);
+}
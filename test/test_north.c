@@ -12,6 +12,9 @@ int main(void) {
         cmocka_unit_test(entry_ib),
         cmocka_unit_test(entry_token),
         cmocka_unit_test(entry_generic_pool),
+        cmocka_unit_test(entry_lexer),
+        cmocka_unit_test(entry_ntok),
+        cmocka_unit_test(entry_symbol),
     };
     return cmocka_run_group_tests(sub_tests, NULL, NULL);
 }
@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "lexer/ntok.h"
+#include "lexer/literal.h"
+
+#define MACRO_UNUSED(x) (void)(x)
+#define NTOK_TEST_PATH  "north_test_cache.ntok"
+
+
+static char* build_source(size_t target, size_t* out_len) {
+    static const char* snippets[] = {
+        "fn f(a: u32) -> u32 { a + 1 }\n",
+        "let s = \"multi\nline\nstring\";\n",
+        "/* block\ncomment /* nested\n */ */\n",
+        "let r = r#\"raw\n\"quoted\"\n\"#;\n",
+        "/// doc line\nstruct S { x: f64 }\n",
+        "let v = [1.5e3, 0x_ffu8, 'c', b'\\n', \"esc\\\"aped\"];\n",
+        "impl<'a> T for &'a S { fn g(&self) -> i64 { r#match - 7i64 } }\n",
+    };
+    char* buf = malloc(target + 256);
+    size_t len = 0;
+    for (size_t i = 0; len < target; i++) {
+        const char* s = snippets[(i * 5) % (sizeof(snippets) / sizeof(snippets[0]))];
+        size_t n = strlen(s);
+        memcpy(buf + len, s, n);
+        len += n;
+    }
+    *out_len = len;
+    return buf;
+}
+
+// 缓存视图须与原Token流逐个一致
+static void assert_view_matches(const NtokView* view, const TokenStream* stream) {
+    assert_int_equal(view->count, stream->count);
+    size_t i = 0;
+    for (const Token* t = stream->head; t; t = t->next, ++i) {
+        assert_int_equal(ntok_kind(view, i), t->type);
+        assert_int_equal(view->spans[i].start, t->span.lo - stream->base);
+        assert_int_equal(view->spans[i].len, t->span.len);
+        const NtokPayload* p = &view->payloads[i];
+        switch (t->type) {
+            case Tk_Ident:
+            case Tk_Lifetime:
+                assert_string_equal(ntok_text(view, i), symbol_str(t->data.ident.symbol));
+                assert_int_equal(p->flags, t->data.ident.is_raw);
+                break;
+            case Tk_Literal: {
+                const Literal* lit = token_literal(t);
+                assert_string_equal(ntok_text(view, i), symbol_str(lit->symbol));
+                assert_int_equal(p->sub, lit->kind);
+                assert_string_equal(view->string_data + view->strings[p->aux].offset, symbol_str(lit->suffix));
+                break;
+            }
+            case Tk_DocComment:
+                assert_string_equal(ntok_text(view, i), symbol_str(t->data.doc_comment.symbol));
+                break;
+            case Tk_OpenDelim:
+            case Tk_CloseDelim:
+                assert_int_equal(p->sub, t->data.delim.delim);
+                break;
+            default:
+                assert_null(ntok_text(view, i));
+                break;
+        }
+    }
+}
+
+
+// ==============================================================
+/// @brief 基础功能测试::写入、mmap加载并原位访问
+/// @param state
+static void test_ntok_roundtrip(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    size_t len = 0;
+    char* src = build_source(1 << 14, &len);
+    TokenStream ts;
+    lexer_tokenize(src, len, &ts);
+
+    assert_int_equal(ntok_write(NTOK_TEST_PATH, src, len, &ts), 0);
+    NtokView view;
+    assert_int_equal(ntok_open(NTOK_TEST_PATH, src, len, &view), 0);
+    assert_view_matches(&view, &ts);
+    // 重复文本只存一份
+    assert_true(view.header->string_count < view.count / 4);
+    ntok_close(&view);
+
+    token_stream_free(&ts);
+    unlink(NTOK_TEST_PATH);
+    free(src);
+    token_pool_cleanup();
+}
+
+// 就地改写缓存文件中的若干字节
+static void ntok_patch(const char* path, uint64_t offset, const void* data, size_t size) {
+    FILE* f = fopen(path, "r+b");
+    assert_non_null(f);
+    fseek(f, (long)offset, SEEK_SET);
+    assert_int_equal(fwrite(data, size, 1, f), 1);
+    fclose(f);
+}
+
+// ==============================================================
+/// @brief 失效场景::源码变化、版本不符、截断文件、越界索引均被拒绝，驱动回退到词法分析；
+///        缓存写入失败时仍使用分析结果
+/// @param state
+static void test_ntok_invalidation(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    size_t len = 0;
+    char* src = build_source(1 << 12, &len);
+    NtokView view;
+
+    unlink(NTOK_TEST_PATH);
+    assert_int_equal(ntok_open(NTOK_TEST_PATH, src, len, &view), -1);
+    assert_int_equal(ntok_load_or_lex(NTOK_TEST_PATH, src, len, &view), 0);      // 未命中：分析并写缓存
+    ntok_close(&view);
+    assert_int_equal(ntok_load_or_lex(NTOK_TEST_PATH, src, len, &view), 1);      // 命中
+    size_t count = view.count;
+    ntok_close(&view);
+
+    // 同长度内容变化
+    src[10] = src[10] == 'x' ? 'y' : 'x';
+    assert_int_equal(ntok_open(NTOK_TEST_PATH, src, len, &view), -1);
+    assert_int_equal(ntok_load_or_lex(NTOK_TEST_PATH, src, len, &view), 0);
+    assert_int_equal(view.count, count);
+    ntok_close(&view);
+
+    // 篡改版本号
+    FILE* f = fopen(NTOK_TEST_PATH, "r+b");
+    assert_non_null(f);
+    uint16_t bad = NTOK_VERSION + 1;
+    fseek(f, offsetof(NtokHeader, version), SEEK_SET);
+    fwrite(&bad, sizeof(bad), 1, f);
+    fclose(f);
+    assert_int_equal(ntok_open(NTOK_TEST_PATH, src, len, &view), -1);
+
+    // 截断文件
+    assert_int_equal(ntok_load_or_lex(NTOK_TEST_PATH, src, len, &view), 0);
+    size_t size = view.map_size;
+    ntok_close(&view);
+    assert_int_equal(truncate(NTOK_TEST_PATH, (off_t)(size - 8)), 0);
+    assert_int_equal(ntok_open(NTOK_TEST_PATH, src, len, &view), -1);
+
+    // 区段在界内但内容越界：字符串索引、字符串区间、Token种类
+    NtokHeader h;
+    assert_int_equal(ntok_load_or_lex(NTOK_TEST_PATH, src, len, &view), 0);
+    h = *view.header;
+    ntok_close(&view);
+    uint32_t bad_text = h.string_count;
+    ntok_patch(NTOK_TEST_PATH, h.payloads_offset + offsetof(NtokPayload, text), &bad_text, sizeof(bad_text));
+    assert_int_equal(ntok_open(NTOK_TEST_PATH, src, len, &view), -1);
+
+    assert_int_equal(ntok_load_or_lex(NTOK_TEST_PATH, src, len, &view), 0);
+    h = *view.header;
+    ntok_close(&view);
+    uint32_t bad_len = (uint32_t)h.string_bytes;
+    ntok_patch(NTOK_TEST_PATH, h.strings_offset + offsetof(NtokString, len), &bad_len, sizeof(bad_len));
+    assert_int_equal(ntok_open(NTOK_TEST_PATH, src, len, &view), -1);
+
+    assert_int_equal(ntok_load_or_lex(NTOK_TEST_PATH, src, len, &view), 0);
+    h = *view.header;
+    ntok_close(&view);
+    uint8_t bad_kind = 0xFF;
+    ntok_patch(NTOK_TEST_PATH, h.kinds_offset, &bad_kind, sizeof(bad_kind));
+    assert_int_equal(ntok_open(NTOK_TEST_PATH, src, len, &view), -1);
+
+    // 缓存不可写：仍返回分析结果，视图指向内存映像
+    const char* unwritable = "north_no_such_dir/cache.ntok";
+    assert_int_equal(ntok_load_or_lex(unwritable, src, len, &view), 2);
+    assert_false(view.mapped);
+    TokenStream ts;
+    lexer_tokenize(src, len, &ts);
+    assert_view_matches(&view, &ts);
+    token_stream_free(&ts);
+    ntok_close(&view);
+    assert_int_equal(ntok_open(unwritable, src, len, &view), -1);
+
+    unlink(NTOK_TEST_PATH);
+    free(src);
+    token_pool_cleanup();
+}
+
+// ==============================================================
+/// @brief 性能测试::冷启动词法分析 vs mmap加载缓存
+/// @param state
+static double ntok_secs(const struct timespec* t0, const struct timespec* t1) {
+    return (t1->tv_sec - t0->tv_sec) + (t1->tv_nsec - t0->tv_nsec) * 1e-9;
+}
+
+static void benchmark_ntok_load(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    size_t len = 0;
+    char* src = build_source(8u << 20, &len);
+
+    struct timespec t0, t1;
+    TokenStream ts;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    lexer_tokenize(src, len, &ts);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double lex = ntok_secs(&t0, &t1);
+    assert_int_equal(ntok_write(NTOK_TEST_PATH, src, len, &ts), 0);
+    token_stream_free(&ts);
+
+    NtokView view;
+    size_t idents = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    assert_int_equal(ntok_open(NTOK_TEST_PATH, src, len, &view), 0);
+    for (size_t i = 0; i < view.count; i++) idents += ntok_kind(&view, i) == Tk_Ident;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double load = ntok_secs(&t0, &t1);
+    assert_true(idents > 0);
+
+    double mb = len / (1024.0 * 1024.0);
+    printf("[Ntok] %zu tokens, cold lex: %.2f ms (%.2f MB/sec), mmap load + validate: %.2f ms (%.2f MB/sec)\n",
+        view.count, lex * 1e3, mb / lex, load * 1e3, mb / load);
+    ntok_close(&view);
+
+    unlink(NTOK_TEST_PATH);
+    free(src);
+    token_pool_cleanup();
+}
+
+
+void entry_ntok(void** state) {
+    MACRO_UNUSED(state);
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_ntok_roundtrip),
+        cmocka_unit_test(test_ntok_invalidation),
+        cmocka_unit_test(benchmark_ntok_load),
+    };
+    cmocka_run_group_tests(tests, NULL, NULL);
+}
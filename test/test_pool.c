@@ -98,13 +98,11 @@ static void test_edge_cases(void** state) {
     Pool* pool = pool_create(64, 10);
     assert_non_null(pool);
 
-    // 分配超过容量
+    // 分配超过初始容量：池自动扩容
     void* objs[20];
     size_t count = pool_alloc_batch(pool, objs, 20);
-    assert_int_equal(count, 10);
-    
-    // 测试池耗尽
-    // assert_null(pool_alloc(pool));
+    assert_int_equal(count, 20);
+    assert_true(get_capacity(pool) >= 20);
     
     // only free allocated objects -> destroy pool
     pool_free_batch(pool, objs, count);
@@ -357,6 +355,537 @@ void test_benchmark_concurrent_ops() {
 // =======================================================================================
 
 
+// =======================================================================================
+// 扩容：超出初始容量后按chunk追加，节点互不重叠且保持对齐
+static int ptr_compare(const void* a, const void* b) {
+    uintptr_t x = *(const uintptr_t*)a, y = *(const uintptr_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void test_pool_grow(void** state) {
+    (void)state;
+    const size_t n = 10000;
+    Pool* pool = pool_create(sizeof(uint64_t), 4);
+    assert_non_null(pool);
+    assert_int_equal(get_capacity(pool), 4);
+    assert_int_equal(get_chunk_count(pool), 1);
+
+    uint64_t** objs = malloc(n * sizeof(*objs));
+    for (size_t i = 0; i < n; ++i) {
+        objs[i] = pool_alloc(pool);
+        assert_non_null(objs[i]);
+        assert_int_equal((uintptr_t)objs[i] % 16, 0);
+        *objs[i] = i;
+    }
+    // 几何增长：4→8→16→...，chunk数为对数级
+    assert_true(get_capacity(pool) >= n);
+    assert_true(get_capacity(pool) < 2 * n);
+    assert_true(get_chunk_count(pool) <= 16);
+    for (size_t i = 0; i < n; ++i) {
+        assert_int_equal(*objs[i], i);
+    }
+    qsort(objs, n, sizeof(*objs), ptr_compare);
+    for (size_t i = 1; i < n; ++i) {
+        assert_true((uintptr_t)objs[i] - (uintptr_t)objs[i - 1] >= CACHE_LINE_SIZE);
+    }
+
+    // 释放后再分配不再扩容
+    size_t cap = get_capacity(pool);
+    for (size_t i = 0; i < n; ++i) pool_free(pool, objs[i]);
+    for (size_t i = 0; i < n; ++i) objs[i] = pool_alloc(pool);
+    assert_int_equal(get_capacity(pool), cap);
+    for (size_t i = 0; i < n; ++i) pool_free(pool, objs[i]);
+
+    // 批量接口同样触发扩容
+    void* batch[100];
+    size_t got = pool_alloc_batch(pool, batch, 100);
+    assert_int_equal(got, 100);
+    pool_free_batch(pool, batch, got);
+
+    free(objs);
+    pool_destroy(&pool);
+    assert_null(pool);
+}
+// =======================================================================================
+
+
+// =======================================================================================
+// 多线程扩容：16线程同时从小容量池持有大量对象
+#define GROW_THREADS 16
+#define GROW_OPS_PER_THREAD 20000
+
+typedef struct {
+    Pool* pool;
+    void** objs;
+    size_t count;
+    size_t got;
+} GrowArgs;
+
+static void* grow_thread(void* arg) {
+    GrowArgs* a = arg;
+    a->got = 0;
+    for (size_t i = 0; i < a->count; ++i) {
+        uint64_t* p = pool_alloc(a->pool);
+        if (!p) break;
+        *p = (uintptr_t)p;
+        a->objs[a->got++] = p;
+    }
+    return NULL;
+}
+
+static void* release_thread(void* arg) {
+    GrowArgs* a = arg;
+    for (size_t i = 0; i < a->got; ++i) {
+        pool_free(a->pool, a->objs[i]);
+    }
+    return NULL;
+}
+
+// 各线程分配并持有count个对象，返回分配阶段耗时；对象由调用方释放
+static double grow_run(Pool* pool, GrowArgs* args, size_t count) {
+    pthread_t threads[GROW_THREADS];
+    double start = get_high_res_time();
+    for (int t = 0; t < GROW_THREADS; ++t) {
+        args[t].pool = pool;
+        args[t].count = count;
+        pthread_create(&threads[t], NULL, grow_thread, &args[t]);
+    }
+    for (int t = 0; t < GROW_THREADS; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+    return get_high_res_time() - start;
+}
+
+static void grow_release(Pool* pool, GrowArgs* args) {
+    pthread_t threads[GROW_THREADS];
+    for (int t = 0; t < GROW_THREADS; ++t) {
+        args[t].pool = pool;
+        pthread_create(&threads[t], NULL, release_thread, &args[t]);
+    }
+    for (int t = 0; t < GROW_THREADS; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+}
+
+static void test_pool_grow_concurrent(void** state) {
+    (void)state;
+    const size_t per = 5000, total = per * GROW_THREADS;
+    Pool* pool = pool_create(sizeof(uint64_t), 16);
+    GrowArgs args[GROW_THREADS];
+    void** all = malloc(total * sizeof(void*));
+    for (int t = 0; t < GROW_THREADS; ++t) {
+        args[t].objs = all + t * per;
+    }
+
+    grow_run(pool, args, per);
+    for (int t = 0; t < GROW_THREADS; ++t) {
+        assert_int_equal(args[t].got, per);
+    }
+    assert_int_equal(get_alloc_cnt(pool), total);
+    assert_true(get_capacity(pool) >= total);
+
+    // 无重复分配，写入内容未被其他线程覆盖
+    for (size_t i = 0; i < total; ++i) {
+        assert_int_equal(*(uint64_t*)all[i], (uintptr_t)all[i]);
+    }
+    qsort(all, total, sizeof(void*), ptr_compare);
+    for (size_t i = 1; i < total; ++i) {
+        assert_true(all[i] != all[i - 1]);
+    }
+
+    grow_release(pool, args);
+    assert_int_equal(get_alloc_cnt(pool), get_free_cnt(pool));
+    free(all);
+    pool_destroy(&pool);
+}
+
+// 对比：从小容量起步并发扩容 vs 预分配到最终容量
+static void benchmark_pool_grow(void** state) {
+    (void)state;
+    const size_t total = (size_t)GROW_OPS_PER_THREAD * GROW_THREADS;
+    GrowArgs args[GROW_THREADS];
+    void** all = malloc(total * sizeof(void*));
+    for (int t = 0; t < GROW_THREADS; ++t) {
+        args[t].objs = all + t * GROW_OPS_PER_THREAD;
+    }
+
+    for (int round = 0; round < 3; ++round) {
+        Pool* grown = pool_create(sizeof(uint64_t), 64);
+        double grow_time = grow_run(grown, args, GROW_OPS_PER_THREAD);
+        assert_int_equal(get_alloc_cnt(grown), total);
+        size_t chunks = get_chunk_count(grown), cap = get_capacity(grown);
+        grow_release(grown, args);
+        // 扩容后的池再跑一轮：与预分配池速度一致
+        double reuse_time = grow_run(grown, args, GROW_OPS_PER_THREAD);
+        assert_int_equal(get_capacity(grown), cap);
+        grow_release(grown, args);
+        pool_destroy(&grown);
+
+        Pool* fixed = pool_create(sizeof(uint64_t), total);
+        double fixed_time = grow_run(fixed, args, GROW_OPS_PER_THREAD);
+        assert_int_equal(get_chunk_count(fixed), 1);
+        grow_release(fixed, args);
+        pool_destroy(&fixed);
+
+        printf("[Grow] %d Threads, %zu objs: grow from 64 %.2f Mops/sec (%zu chunks, cap %zu), "
+            "reuse %.2f Mops/sec, presized %.2f Mops/sec\n",
+            GROW_THREADS, total,
+            total / grow_time / 1e6, chunks, cap,
+            total / reuse_time / 1e6,
+            total / fixed_time / 1e6
+        );
+    }
+    free(all);
+}
+// =======================================================================================
+
+
+// =======================================================================================
+// 线程缓存：按Pool隔离，线程退出时弹匣交还仓库
+typedef struct {
+    Pool* pool;
+    size_t count;
+} CacheWorkerArgs;
+
+static void* pool_cache_worker(void* arg) {
+    CacheWorkerArgs* a = arg;
+    void** objs = malloc(a->count * sizeof(void*));
+    for (size_t i = 0; i < a->count; ++i) {
+        objs[i] = pool_alloc(a->pool);
+        assert_non_null(objs[i]);
+    }
+    for (size_t i = 0; i < a->count; ++i) {
+        pool_free(a->pool, objs[i]);
+    }
+    free(objs);
+    return NULL;
+}
+
+static void test_pool_thread_cache(void** state) {
+    (void)state;
+    Pool* a = pool_create(64, 128);
+    Pool* b = pool_create(64, 128);
+    void* from_a[100];
+    void* from_b[100];
+
+    // a的对象缓存在本线程a的弹匣中，不得经b分配出去
+    for (int i = 0; i < 100; ++i) from_a[i] = pool_alloc(a);
+    for (int i = 0; i < 100; ++i) pool_free(a, from_a[i]);
+    assert_int_equal(pool_alloc_batch(b, from_b, 50), 50);
+    for (int i = 50; i < 100; ++i) from_b[i] = pool_alloc(b);
+    for (int i = 0; i < 100; ++i) {
+        for (int j = 0; j < 100; ++j) {
+            assert_true(from_b[i] != from_a[j]);
+        }
+    }
+    pool_free_batch(b, from_b, 100);
+    assert_int_equal(get_alloc_cnt(a), 100);
+    assert_int_equal(get_free_cnt(a), 100);
+    assert_int_equal(get_alloc_cnt(b), 100);
+    assert_int_equal(get_free_cnt(b), 100);
+
+    // 工作线程耗尽容量后退出：其缓存的对象可被本线程复用，无需扩容
+    Pool* c = pool_create(64, 256);
+    CacheWorkerArgs args = { .pool = c, .count = 256 };
+    pthread_t tid;
+    pthread_create(&tid, NULL, pool_cache_worker, &args);
+    pthread_join(tid, NULL);
+    assert_int_equal(get_alloc_cnt(c), 256);
+    assert_int_equal(get_free_cnt(c), 256);
+
+    void* objs[256];
+    assert_int_equal(pool_alloc_batch(c, objs, 256), 256);
+    assert_int_equal(get_capacity(c), 256);
+    pool_free_batch(c, objs, 256);
+
+    pool_destroy(&a);
+    pool_destroy(&b);
+    pool_destroy(&c);
+
+    // 销毁后同一地址上的新Pool不会误用旧缓存
+    for (int i = 0; i < 100; ++i) {
+        Pool* p = pool_create(64, 16);
+        void* obj = pool_alloc(p);
+        assert_non_null(obj);
+        pool_free(p, obj);
+        assert_int_equal(get_alloc_cnt(p), 1);
+        pool_destroy(&p);
+    }
+}
+// =======================================================================================
+
+
+// =======================================================================================
+// 销毁与缓存清理并发：工作线程在Pool上持有缓存，主线程销毁该Pool的同时，
+// 工作线程不断在新Pool上创建缓存（每次创建都会释放本线程已解绑的缓存）
+#define DESTROY_RACE_ROUNDS 200
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    Pool* pool;                 // 本轮交给工作线程的Pool
+    int round;                  // 主线程已发布的轮次
+    int used;                   // 工作线程已在其上建立缓存的轮次
+    int destroyed;              // 主线程已销毁的轮次
+} DestroyRaceArgs;
+
+static void* destroy_race_worker(void* arg) {
+    DestroyRaceArgs* a = arg;
+    for (int r = 1; r <= DESTROY_RACE_ROUNDS; ++r) {
+        pthread_mutex_lock(&a->lock);
+        while (a->round != r) pthread_cond_wait(&a->cond, &a->lock);
+        Pool* pool = a->pool;
+        pthread_mutex_unlock(&a->lock);
+
+        void* obj = pool_alloc(pool);
+        assert_non_null(obj);
+        pool_free(pool, obj);
+
+        pthread_mutex_lock(&a->lock);
+        a->used = r;
+        pthread_cond_broadcast(&a->cond);
+        pthread_mutex_unlock(&a->lock);
+
+        for (int done = 0; !done; ) {
+            Pool* fresh = pool_create(64, 16);
+            void* p = pool_alloc(fresh);
+            assert_non_null(p);
+            pool_free(fresh, p);
+            pool_destroy(&fresh);
+            pthread_mutex_lock(&a->lock);
+            done = a->destroyed == r;
+            pthread_mutex_unlock(&a->lock);
+        }
+    }
+    return NULL;
+}
+
+static void test_pool_destroy_race(void** state) {
+    (void)state;
+    DestroyRaceArgs args = { .lock = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER };
+    pthread_t tid;
+    pthread_create(&tid, NULL, destroy_race_worker, &args);
+
+    for (int r = 1; r <= DESTROY_RACE_ROUNDS; ++r) {
+        // 本线程先建缓存，工作线程的缓存排在depot.caches表头，销毁时先解绑它再读next
+        Pool* pool = pool_create(64, 16);
+        void* obj = pool_alloc(pool);
+        assert_non_null(obj);
+        pool_free(pool, obj);
+
+        pthread_mutex_lock(&args.lock);
+        args.pool = pool;
+        args.round = r;
+        pthread_cond_broadcast(&args.cond);
+        while (args.used != r) pthread_cond_wait(&args.cond, &args.lock);
+        pthread_mutex_unlock(&args.lock);
+
+        pool_destroy(&pool);
+        assert_null(pool);
+        pthread_mutex_lock(&args.lock);
+        args.destroyed = r;
+        pthread_mutex_unlock(&args.lock);
+    }
+    pthread_join(tid, NULL);
+}
+// =======================================================================================
+
+
+// =======================================================================================
+// 回收线程：休眠线程缓存中的对象被归还，可供其他线程复用
+typedef struct {
+    Pool* pool;
+    size_t count;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int stage;                  // 1: 工作线程已释放全部对象；2: 允许退出
+} ParkedArgs;
+
+static void* parked_worker(void* arg) {
+    ParkedArgs* a = arg;
+    void** objs = malloc(a->count * sizeof(void*));
+    for (size_t i = 0; i < a->count; ++i) objs[i] = pool_alloc(a->pool);
+    for (size_t i = 0; i < a->count; ++i) pool_free(a->pool, objs[i]);
+    free(objs);
+
+    pthread_mutex_lock(&a->lock);
+    a->stage = 1;
+    pthread_cond_broadcast(&a->cond);
+    while (a->stage != 2) pthread_cond_wait(&a->cond, &a->lock);
+    pthread_mutex_unlock(&a->lock);
+    return NULL;
+}
+
+static void test_pool_reaper(void** state) {
+    (void)state;
+    const size_t cap = 512;
+    Pool* pool = pool_create(64, cap);
+    ParkedArgs args = { .pool = pool, .count = cap, .stage = 0 };
+    pthread_mutex_init(&args.lock, NULL);
+    pthread_cond_init(&args.cond, NULL);
+
+    PoolReaperConfig bad = POOL_REAPER_DEFAULT;
+    bad.depot_low = bad.depot_high + 1;
+    assert_int_equal(pool_start_reaper_config(pool, &bad), -1);
+
+    pthread_t tid;
+    pthread_create(&tid, NULL, parked_worker, &args);
+    pthread_mutex_lock(&args.lock);
+    while (args.stage != 1) pthread_cond_wait(&args.cond, &args.lock);
+    pthread_mutex_unlock(&args.lock);
+
+    // 工作线程仍存活但不再访问pool：全部容量都滞留在其弹匣与仓库中
+    PoolReaperConfig config = {
+        .period_us = 200, .idle_periods = 2, .cache_low = 0, .depot_high = 2, .depot_low = 0,
+    };
+    assert_int_equal(pool_start_reaper_config(pool, &config), 0);
+    assert_int_equal(pool_start_reaper_config(pool, &config), -1);
+    for (int i = 0; i < 5000 && get_reclaimed_cnt(pool) < cap; ++i) {
+        nanosleep(&(struct timespec){0, 1000000}, NULL);
+    }
+    assert_int_equal(get_reclaimed_cnt(pool), cap);
+
+    void* objs[512];
+    for (size_t i = 0; i < cap; ++i) {
+        objs[i] = pool_alloc(pool);
+        assert_non_null(objs[i]);
+    }
+    assert_int_equal(get_capacity(pool), cap);
+    pool_free_batch(pool, objs, cap);
+    pool_stop_reaper(pool);
+    pool_stop_reaper(pool);
+
+    pthread_mutex_lock(&args.lock);
+    args.stage = 2;
+    pthread_cond_broadcast(&args.cond);
+    pthread_mutex_unlock(&args.lock);
+    pthread_join(tid, NULL);
+
+    assert_int_equal(get_alloc_cnt(pool), 2 * cap);
+    assert_int_equal(get_free_cnt(pool), 2 * cap);
+    pthread_mutex_destroy(&args.lock);
+    pthread_cond_destroy(&args.cond);
+    pool_destroy(&pool);
+}
+
+// 回收与分配并发：每个Pool各自的回收线程以最激进的参数运行，对象不得被重复分配
+#define REAPER_STRESS_THREADS 8
+#define REAPER_STRESS_ROUNDS 2000
+#define REAPER_STRESS_HOLD 100
+
+static void* reaper_stress_worker(void* arg) {
+    Pool** pools = arg;
+    uint64_t* held[REAPER_STRESS_HOLD];
+    uint64_t tag = (uintptr_t)held;
+    for (int r = 0; r < REAPER_STRESS_ROUNDS; ++r) {
+        Pool* pool = pools[r & 1];
+        size_t n = (r % 3 == 0) ? pool_alloc_batch(pool, (void**)held, REAPER_STRESS_HOLD) : REAPER_STRESS_HOLD;
+        for (size_t i = (r % 3 == 0) ? n : 0; i < REAPER_STRESS_HOLD; ++i) {
+            held[i] = pool_alloc(pool);
+        }
+        for (size_t i = 0; i < REAPER_STRESS_HOLD; ++i) *held[i] = tag + i;
+        if (r % 16 == 0) sched_yield();
+        for (size_t i = 0; i < REAPER_STRESS_HOLD; ++i) assert_int_equal(*held[i], tag + i);
+        if (r % 2 == 0) {
+            pool_free_batch(pool, (void**)held, REAPER_STRESS_HOLD);
+        } else {
+            for (size_t i = 0; i < REAPER_STRESS_HOLD; ++i) pool_free(pool, held[i]);
+        }
+    }
+    return NULL;
+}
+
+static void test_pool_reaper_concurrent(void** state) {
+    (void)state;
+    Pool* pools[2] = { pool_create(sizeof(uint64_t), 256), pool_create(sizeof(uint64_t), 256) };
+    PoolReaperConfig config = {
+        .period_us = 50, .idle_periods = 0, .cache_low = 0, .depot_high = 0, .depot_low = 0,
+    };
+    assert_int_equal(pool_start_reaper_config(pools[0], &config), 0);
+    assert_int_equal(pool_start_reaper_config(pools[1], &config), 0);
+
+    pthread_t threads[REAPER_STRESS_THREADS];
+    for (int t = 0; t < REAPER_STRESS_THREADS; ++t) {
+        pthread_create(&threads[t], NULL, reaper_stress_worker, pools);
+    }
+    for (int t = 0; t < REAPER_STRESS_THREADS; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    printf("[Reaper] reclaimed %zu + %zu objects\n", get_reclaimed_cnt(pools[0]), get_reclaimed_cnt(pools[1]));
+    for (int i = 0; i < 2; ++i) {
+        assert_int_equal(get_alloc_cnt(pools[i]), get_free_cnt(pools[i]));
+        pool_destroy(&pools[i]);     // 回收线程随pool_destroy停止
+    }
+}
+// =======================================================================================
+
+
+// =======================================================================================
+// CAS成功率与吞吐：1~64线程
+//  list：每轮批量取还后刷新线程缓存，补充与归还都经过无锁链表的CAS
+//  cached：单个分配/释放，走线程缓存
+#define CAS_BENCH_OBJS (1u << 21)       // 每个线程数下的对象总数
+#define CAS_BENCH_BATCH 96
+
+typedef struct {
+    Pool* pool;
+    size_t iters;
+    int cached;
+} CasBenchArgs;
+
+static void* cas_bench_worker(void* arg) {
+    CasBenchArgs* a = arg;
+    void* objs[CAS_BENCH_BATCH];
+    for (size_t i = 0; i < a->iters; ++i) {
+        if (a->cached) {
+            void* p = pool_alloc(a->pool);
+            pool_free(a->pool, p);
+        } else {
+            size_t n = pool_alloc_batch(a->pool, objs, CAS_BENCH_BATCH);
+            pool_free_batch(a->pool, objs, n);
+            pool_flush_cache(a->pool);
+        }
+    }
+    return NULL;
+}
+
+static double cas_bench_run(int threads, int cached, double* success) {
+    Pool* pool = pool_create(sizeof(uint64_t), 64 * CAS_BENCH_BATCH);
+    pthread_t tids[64];
+    CasBenchArgs args = {
+        .pool = pool,
+        .iters = cached ? CAS_BENCH_OBJS / threads : CAS_BENCH_OBJS / CAS_BENCH_BATCH / threads,
+        .cached = cached,
+    };
+    double start = get_high_res_time();
+    for (int t = 0; t < threads; ++t) pthread_create(&tids[t], NULL, cas_bench_worker, &args);
+    for (int t = 0; t < threads; ++t) pthread_join(tids[t], NULL);
+    double duration = get_high_res_time() - start;
+
+    // 工作线程已退出，其缓存上的CAS计数已并入Pool
+    size_t ok = get_cas_success(pool), fail = get_cas_fail(pool);
+    assert_true(ok > 0);
+    *success = ok + fail ? 100.0 * ok / (ok + fail) : 100.0;
+    assert_int_equal(get_alloc_cnt(pool), get_free_cnt(pool));
+    pool_destroy(&pool);
+    size_t objs = args.iters * threads * (cached ? 1 : CAS_BENCH_BATCH);
+    return objs / duration / 1e6;
+}
+
+static void benchmark_pool_cas(void** state) {
+    (void)state;
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        double list_success, cached_success;
+        double list_mops = cas_bench_run(threads, 0, &list_success);
+        double cached_mops = cas_bench_run(threads, 1, &cached_success);
+        printf("[CAS] %2d Threads: list %.2f Mops/sec (CAS success %.2f%%), cached %.2f Mops/sec (CAS success %.2f%%)\n",
+            threads, list_mops, list_success, cached_mops, cached_success);
+    }
+}
+// =======================================================================================
+
+
 
 void entry_generic_pool(void**state) {
     const struct CMUnitTest tests[] = {
@@ -370,6 +899,14 @@ void entry_generic_pool(void**state) {
         cmocka_unit_test(test_stress_memory),
         // cmocka_unit_test(test_concurrent_alloc_free),
         cmocka_unit_test(test_benchmark_concurrent_ops),
+        cmocka_unit_test(test_pool_grow),
+        cmocka_unit_test(test_pool_grow_concurrent),
+        cmocka_unit_test(benchmark_pool_grow),
+        cmocka_unit_test(test_pool_thread_cache),
+        cmocka_unit_test(test_pool_destroy_race),
+        cmocka_unit_test(test_pool_reaper),
+        cmocka_unit_test(test_pool_reaper_concurrent),
+        cmocka_unit_test(benchmark_pool_cas),
     };
     
     cmocka_run_group_tests(tests, NULL, NULL);
@@ -0,0 +1,934 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "lexer/hash.h"
+#include "lexer/symbol.h"
+#include "lexer/lexer.h"
+
+#define MACRO_UNUSED(x) (void)(x)
+
+#define SYMBOL_BENCH_DISTINCT   1000000
+#define SYMBOL_BENCH_REPEATED   10000000
+#define SYMBOL_BENCH_HOT        4096        // 重复内部化时循环使用的标识符数量
+#define SYMBOL_BENCH_WARM       65536       // 超出线程缓存容量的工作集（每次都进入全局表）
+#define SYMBOL_MAX_THREADS      8
+
+
+static double bench_secs(const struct timespec* t0, const struct timespec* t1) {
+    return (double)(t1->tv_sec - t0->tv_sec) + (double)(t1->tv_nsec - t0->tv_nsec) / 1e9;
+}
+
+// 常驻内存（KB）
+static size_t rss_kb(void) {
+    long pages = 0, resident = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(f);
+    return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE) / 1024;
+}
+
+// 生成n个互不相同的名字，连续存放：names[offs[i], offs[i+1])
+static char* make_names(const char* prefix, size_t n, size_t** out_offs) {
+    size_t cap = n * (strlen(prefix) + 12);
+    char* names = malloc(cap);
+    size_t* offs = malloc((n + 1) * sizeof(size_t));
+    size_t len = 0;
+    for (size_t i = 0; i < n; ++i) {
+        offs[i] = len;
+        len += (size_t)snprintf(names + len, cap - len, "%s%zu", prefix, i);
+    }
+    offs[n] = len;
+    *out_offs = offs;
+    return names;
+}
+
+
+// ==============================================================
+/// @brief 内部化::预定义符号、去重与扩容后查找
+/// @param state
+static void test_symbol_intern(void **state) {
+    MACRO_UNUSED(state);
+    symbol_table_init();
+
+    Symbol as = symbol_intern("as", 2);
+    assert_int_equal(as.id, SYM_AS);
+    assert_int_equal(as.flags, SYM_FLAG_PREDEFINED);
+    assert_int_equal(symbol_intern("break", 5).id, SYM_BREAK);
+    assert_int_equal(symbol_intern("", 0).id, SYM_EMPTY);
+
+    Symbol a = symbol_intern("alpha", 5);
+    Symbol b = symbol_intern("alphabet", 5);        // 前缀相同即同一符号
+    Symbol c = symbol_intern("alphb", 5);
+    assert_int_equal(a.flags, SYM_FLAG_INTERNED);
+    assert_int_equal(a.id, b.id);
+    assert_int_not_equal(a.id, c.id);
+    assert_string_equal(symbol_str(a), "alpha");
+    assert_string_equal(symbol_str(c), "alphb");
+
+    // 多次扩容后已有符号的ID不变
+    size_t* offs = NULL;
+    const size_t n = 200000;
+    char* names = make_names("test_symbol_", n, &offs);
+    uint32_t* ids = malloc(n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; ++i) {
+        ids[i] = symbol_intern(names + offs[i], offs[i + 1] - offs[i]).id;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        Symbol s = symbol_intern(names + offs[i], offs[i + 1] - offs[i]);
+        assert_int_equal(s.id, ids[i]);
+        assert_memory_equal(symbol_str(s), names + offs[i], offs[i + 1] - offs[i]);
+    }
+    assert_int_equal(symbol_intern("alpha", 5).id, a.id);
+    assert_int_equal(symbol_intern("as", 2).id, SYM_AS);
+
+    // 内联与字符串区的分界：最长内联、最短外置，以及前4字节相同的长名字
+    const char* edge = "abcdefghijklmnopqrstuvwxyz";
+    Symbol in = symbol_intern(edge, SYMBOL_INLINE_MAX);
+    Symbol out = symbol_intern(edge, SYMBOL_INLINE_MAX + 1);
+    Symbol out2 = symbol_intern("abcdefghijklmnopqrsXYZ", SYMBOL_INLINE_MAX + 1);
+    assert_int_not_equal(in.id, out.id);
+    assert_int_not_equal(out.id, out2.id);
+    assert_int_equal(strlen(symbol_str(in)), SYMBOL_INLINE_MAX);
+    assert_memory_equal(symbol_str(in), edge, SYMBOL_INLINE_MAX);
+    assert_int_equal(strlen(symbol_str(out)), SYMBOL_INLINE_MAX + 1);
+    assert_memory_equal(symbol_str(out), edge, SYMBOL_INLINE_MAX + 1);
+    assert_int_equal(symbol_intern(edge, SYMBOL_INLINE_MAX).id, in.id);
+    assert_int_equal(symbol_intern(edge, SYMBOL_INLINE_MAX + 1).id, out.id);
+    assert_int_equal(symbol_intern("abcdefghijklmnopqrsXYZ", SYMBOL_INLINE_MAX + 1).id, out2.id);
+
+    free(ids);
+    free(offs);
+    free(names);
+}
+
+/// @brief 字符串区::短字符串内联不占字符串区，长字符串分块存放、统计与销毁后重建（含线程本地缓存失效）
+/// @param state
+static void test_symbol_arena(void **state) {
+    MACRO_UNUSED(state);
+    symbol_table_init();
+    SymbolTableStats before, after;
+    symbol_table_stats(&before);
+
+    char big[SYMTAB_ARENA_CHUNK];
+    memset(big, 'x', sizeof(big));
+    Symbol large = symbol_intern(big, sizeof(big));         // 单独成块
+    Symbol small = symbol_intern("arena_small", 11);
+    assert_int_equal(strlen(symbol_str(large)), sizeof(big));
+    assert_string_equal(symbol_str(small), "arena_small");
+    assert_int_equal(symbol_intern(big, sizeof(big)).id, large.id);
+
+    // 短名字内联在条目中，字符串区不增长
+    SymbolTableStats mid;
+    symbol_table_stats(&mid);
+    const size_t short_n = 10000;
+    size_t* short_offs = NULL;
+    char* short_names = make_names("arena_s", short_n, &short_offs);
+    for (size_t i = 0; i < short_n; ++i) {
+        symbol_intern(short_names + short_offs[i], short_offs[i + 1] - short_offs[i]);
+    }
+    symbol_table_stats(&after);
+    assert_int_equal(after.symbols - mid.symbols, short_n);
+    assert_int_equal(after.arena_bytes, mid.arena_bytes);
+    free(short_offs);
+    free(short_names);
+
+    size_t* offs = NULL;
+    const size_t n = 100000;
+    char* names = make_names("test_arena_long_identifier_", n, &offs);
+    for (size_t i = 0; i < n; ++i) symbol_intern(names + offs[i], offs[i + 1] - offs[i]);
+    symbol_table_stats(&after);
+    assert_int_equal(after.symbols - before.symbols, n + short_n + 2);
+    // 约每几千个字符串一次分配，而非每个字符串一次
+    assert_true(after.arena_chunks - before.arena_chunks < n / 100);
+    assert_true(after.arena_bytes - before.arena_bytes >= offs[n] + n + sizeof(big));
+
+    // 销毁后重建：本线程缓存中的旧条目不得再被命中
+    symbol_table_cleanup();
+    symbol_table_stats(&after);
+    assert_int_equal(after.symbols, 0);
+    symbol_table_init();
+    Symbol again = symbol_intern("arena_small", 11);
+    assert_string_equal(symbol_str(again), "arena_small");
+    assert_int_equal(symbol_intern("as", 2).id, SYM_AS);
+    assert_int_equal(symbol_intern(names, offs[1]).id, again.id + 1);
+
+    free(offs);
+    free(names);
+}
+
+/// @brief 内部化::1M个不同标识符与10M次重复标识符
+/// @param state
+static void benchmark_symbol_intern(void **state) {
+    MACRO_UNUSED(state);
+    symbol_table_cleanup();         // 从空表开始统计内存
+    symbol_table_init();
+    size_t* offs = NULL;
+    char* names = make_names("bench_distinct_", SYMBOL_BENCH_DISTINCT, &offs);
+    size_t* hot_offs = NULL;
+    char* hot = make_names("hot_", SYMBOL_BENCH_HOT, &hot_offs);
+
+    struct timespec t0, t1, t2;
+    size_t rss0 = rss_kb();
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (size_t i = 0; i < SYMBOL_BENCH_DISTINCT; ++i) {
+        symbol_intern(names + offs[i], offs[i + 1] - offs[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    size_t rss1 = rss_kb();
+    SymbolTableStats stats;
+    symbol_table_stats(&stats);
+    uint32_t sink = 0;
+    for (size_t i = 0; i < SYMBOL_BENCH_REPEATED; ++i) {
+        size_t k = i & (SYMBOL_BENCH_HOT - 1);
+        sink += symbol_intern(hot + hot_offs[k], hot_offs[k + 1] - hot_offs[k]).id;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    assert_true(sink != 0);
+
+    printf("[Symbol] distinct: %.2f Mops/s, repeated: %.2f Mops/s\n",
+           SYMBOL_BENCH_DISTINCT / bench_secs(&t0, &t1) / 1e6,
+           SYMBOL_BENCH_REPEATED / bench_secs(&t1, &t2) / 1e6);
+    printf("[Symbol] %zu distinct: %zu string mallocs (arena chunks), %zu KB strings, RSS +%zu KB\n",
+           (size_t)SYMBOL_BENCH_DISTINCT, stats.arena_chunks, stats.arena_bytes >> 10, rss1 - rss0);
+
+    free(hot_offs);
+    free(hot);
+    free(offs);
+    free(names);
+}
+
+
+// ==============================================================
+/// @brief 并发内部化::各线程以不同顺序内部化同一批名字，ID须一致；读者无锁读取
+/// @param state
+typedef struct InternArgs {
+    const char* names;
+    const size_t* offs;
+    size_t n;
+    size_t stride;          // 遍历步长（与n互质），使各线程顺序不同
+    size_t reps;
+    uint32_t* ids;          // 按名字下标记录的ID
+    atomic_bool* stop;
+} InternArgs;
+
+static void* intern_worker(void* arg) {
+    InternArgs* a = arg;
+    for (size_t r = 0; r < a->reps; ++r) {
+        for (size_t i = 0, k = 0; i < a->n; ++i, k = (k + a->stride) % a->n) {
+            a->ids[k] = symbol_intern(a->names + a->offs[k], a->offs[k + 1] - a->offs[k]).id;
+        }
+    }
+    return NULL;
+}
+
+// 反复读取已发布的符号，期间其他线程持续扩充条目段与索引
+static void* reader_worker(void* arg) {
+    InternArgs* a = arg;
+    while (!atomic_load_explicit(a->stop, memory_order_acquire)) {
+        for (size_t i = 0; i < a->n; ++i) {
+            Symbol s = {a->ids[i], SYM_FLAG_INTERNED};
+            assert_memory_equal(symbol_str(s), a->names + a->offs[i], a->offs[i + 1] - a->offs[i]);
+        }
+    }
+    return NULL;
+}
+
+static void test_symbol_concurrent(void **state) {
+    MACRO_UNUSED(state);
+    symbol_table_init();
+    size_t* offs = NULL;
+    const size_t n = 50000;
+    char* names = make_names("test_concurrent_", n, &offs);
+
+    // 读者使用的符号先在主线程发布
+    size_t* pub_offs = NULL;
+    const size_t pub_n = 1000;
+    char* pub = make_names("test_published_", pub_n, &pub_offs);
+    uint32_t* pub_ids = malloc(pub_n * sizeof(uint32_t));
+    for (size_t i = 0; i < pub_n; ++i) {
+        pub_ids[i] = symbol_intern(pub + pub_offs[i], pub_offs[i + 1] - pub_offs[i]).id;
+    }
+
+    atomic_bool stop = false;
+    InternArgs reader = { pub, pub_offs, pub_n, 1, 1, pub_ids, &stop };
+    pthread_t reader_tid;
+    assert_int_equal(pthread_create(&reader_tid, NULL, reader_worker, &reader), 0);
+
+    const size_t strides[SYMBOL_MAX_THREADS] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+    InternArgs args[SYMBOL_MAX_THREADS];
+    pthread_t tids[SYMBOL_MAX_THREADS];
+    for (size_t t = 0; t < SYMBOL_MAX_THREADS; ++t) {
+        args[t] = (InternArgs){ names, offs, n, strides[t], 2, malloc(n * sizeof(uint32_t)), &stop };
+        assert_int_equal(pthread_create(&tids[t], NULL, intern_worker, &args[t]), 0);
+    }
+    for (size_t t = 0; t < SYMBOL_MAX_THREADS; ++t) pthread_join(tids[t], NULL);
+    atomic_store_explicit(&stop, true, memory_order_release);
+    pthread_join(reader_tid, NULL);
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t t = 1; t < SYMBOL_MAX_THREADS; ++t) {
+            assert_int_equal(args[t].ids[i], args[0].ids[i]);
+        }
+        Symbol s = {args[0].ids[i], SYM_FLAG_INTERNED};
+        assert_memory_equal(symbol_str(s), names + offs[i], offs[i + 1] - offs[i]);
+    }
+    // 不同名字ID互不相同
+    for (size_t i = 1; i < n; ++i) assert_int_not_equal(args[0].ids[i], args[0].ids[i - 1]);
+
+    for (size_t t = 0; t < SYMBOL_MAX_THREADS; ++t) free(args[t].ids);
+    free(pub_ids);
+    free(pub_offs);
+    free(pub);
+    free(offs);
+    free(names);
+}
+
+/// @brief 并发内部化::1~8个线程的总吞吐
+/// @param state
+static void benchmark_symbol_intern_threads(void **state) {
+    MACRO_UNUSED(state);
+    symbol_table_init();
+    size_t* offs = NULL;
+    char* names = make_names("hot_", SYMBOL_BENCH_HOT, &offs);
+    for (size_t threads = 1; threads <= SYMBOL_MAX_THREADS; threads *= 2) {
+        InternArgs args[SYMBOL_MAX_THREADS];
+        pthread_t tids[SYMBOL_MAX_THREADS];
+        const size_t reps = SYMBOL_BENCH_REPEATED / SYMBOL_BENCH_HOT / threads;
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (size_t t = 0; t < threads; ++t) {
+            args[t] = (InternArgs){ names, offs, SYMBOL_BENCH_HOT, 2 * t + 1, reps,
+                                    malloc(SYMBOL_BENCH_HOT * sizeof(uint32_t)), NULL };
+            pthread_create(&tids[t], NULL, intern_worker, &args[t]);
+        }
+        for (size_t t = 0; t < threads; ++t) pthread_join(tids[t], NULL);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        for (size_t t = 0; t < threads; ++t) free(args[t].ids);
+        printf("[Symbol] Threads: %zu, repeated intern: %.2f Mops/s\n",
+               threads, (double)(reps * threads * SYMBOL_BENCH_HOT) / bench_secs(&t0, &t1) / 1e6);
+    }
+    free(offs);
+    free(names);
+
+    // 线程缓存装不下的工作集：每次内部化都查找全局表中的已有符号
+    names = make_names("warm_", SYMBOL_BENCH_WARM, &offs);
+    for (size_t threads = 1; threads <= SYMBOL_MAX_THREADS; threads *= 2) {
+        InternArgs args[SYMBOL_MAX_THREADS];
+        pthread_t tids[SYMBOL_MAX_THREADS];
+        const size_t reps = SYMBOL_BENCH_REPEATED / 4 / SYMBOL_BENCH_WARM / threads;
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (size_t t = 0; t < threads; ++t) {
+            args[t] = (InternArgs){ names, offs, SYMBOL_BENCH_WARM, 2 * t + 1, reps,
+                                    malloc(SYMBOL_BENCH_WARM * sizeof(uint32_t)), NULL };
+            pthread_create(&tids[t], NULL, intern_worker, &args[t]);
+        }
+        for (size_t t = 0; t < threads; ++t) pthread_join(tids[t], NULL);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        for (size_t t = 0; t < threads; ++t) free(args[t].ids);
+        printf("[Symbol] Threads: %zu, cache-missing intern: %.2f Mops/s\n",
+               threads, (double)(reps * threads * SYMBOL_BENCH_WARM) / bench_secs(&t0, &t1) / 1e6);
+    }
+    free(offs);
+    free(names);
+}
+
+// 生成n个长度恰为len的名字（len >= 4）：十六进制序号左侧以'x'补齐
+static char* make_names_len(size_t len, size_t n) {
+    char* names = malloc(n * len + 1);
+    for (size_t i = 0; i < n; ++i) {
+        memset(names + i * len, 'x', len);
+        char digits[16];
+        int d = snprintf(digits, sizeof(digits), "%04zx", i);
+        memcpy(names + i * len + len - (size_t)d, digits, (size_t)d);
+    }
+    return names;
+}
+
+/// @brief 内部化::按标识符长度的已有符号查找延迟（工作集超出线程缓存，走全局表）
+/// @param state
+static void benchmark_symbol_lookup(void **state) {
+    MACRO_UNUSED(state);
+    static const size_t lens[] = { 4, 8, 12, 16, 19, 20, 32, 64 };
+    const size_t lookups = 4U << 20;
+    symbol_table_init();
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); ++l) {
+        const size_t len = lens[l];
+        char* names = make_names_len(len, SYMBOL_BENCH_WARM);
+        for (size_t i = 0; i < SYMBOL_BENCH_WARM; ++i) symbol_intern(names + i * len, len);
+
+        struct timespec t0, t1;
+        uint32_t sink = 0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (size_t i = 0, k = 0; i < lookups; ++i, k = (k + 7919) & (SYMBOL_BENCH_WARM - 1)) {
+            sink += symbol_intern(names + k * len, len).id;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        assert_true(sink != 0);
+        printf("[Symbol] lookup %2zu B identifiers: %.1f ns/op\n", len, bench_secs(&t0, &t1) * 1e9 / (double)lookups);
+        free(names);
+    }
+}
+
+// ==============================================================
+/// @brief 批量内部化::与逐个内部化结果一致（含块内重复、空串、预定义、长名字与多线程）
+/// @param state
+typedef struct BatchArgs {
+    const char** strs;
+    const size_t* lens;
+    size_t n;
+    size_t rotate;          // 起始偏移，使各线程插入顺序不同
+    Symbol* out;
+} BatchArgs;
+
+static void* batch_worker(void* arg) {
+    BatchArgs* a = arg;
+    const char** strs = malloc(a->n * sizeof(char*));
+    size_t* lens = malloc(a->n * sizeof(size_t));
+    Symbol* out = malloc(a->n * sizeof(Symbol));
+    for (size_t i = 0; i < a->n; ++i) {
+        strs[i] = a->strs[(i + a->rotate) % a->n];
+        lens[i] = a->lens[(i + a->rotate) % a->n];
+    }
+    symbol_intern_batch(strs, lens, a->n, out);
+    for (size_t i = 0; i < a->n; ++i) a->out[(i + a->rotate) % a->n] = out[i];
+    free(strs);
+    free(lens);
+    free(out);
+    return NULL;
+}
+
+static void test_symbol_batch(void **state) {
+    MACRO_UNUSED(state);
+    symbol_table_init();
+    size_t* offs = NULL;
+    const size_t names_n = 300;
+    char* names = make_names("test_batch_identifier_", names_n, &offs);
+
+    // 1000个输入：名字循环出现（同一块内有重复），穿插空串、预定义符号与短名字
+    const size_t n = 1000;
+    const char** strs = malloc(n * sizeof(char*));
+    size_t* lens = malloc(n * sizeof(size_t));
+    Symbol* out = malloc(n * sizeof(Symbol));
+    for (size_t i = 0; i < n; ++i) {
+        size_t k = (i * 7) % names_n;
+        strs[i] = names + offs[k];
+        lens[i] = offs[k + 1] - offs[k];
+        if (i % 97 == 1) lens[i] = 0;
+        else if (i % 101 == 2) { strs[i] = "as"; lens[i] = 2; }
+        else if (i % 89 == 3) lens[i] = 12;     // 前缀"test_batch_i"，短名字
+    }
+    symbol_intern_batch(strs, lens, n, out);
+    for (size_t i = 0; i < n; ++i) {
+        Symbol s = symbol_intern(strs[i], lens[i]);
+        assert_int_equal(out[i].id, s.id);
+        assert_int_equal(out[i].flags, s.flags);
+    }
+    assert_int_equal(out[1].id, SYM_EMPTY);
+    assert_int_equal(out[2].id, SYM_AS);
+    // 已全部存在：再次批量内部化结果不变
+    Symbol* again = malloc(n * sizeof(Symbol));
+    symbol_intern_batch(strs, lens, n, again);
+    for (size_t i = 0; i < n; ++i) assert_int_equal(again[i].id, out[i].id);
+
+    // 多线程以不同顺序批量插入同一批新名字
+    size_t* conc_offs = NULL;
+    const size_t conc_n = 20000;
+    char* conc = make_names("test_batch_concurrent_", conc_n, &conc_offs);
+    const char** conc_strs = malloc(conc_n * sizeof(char*));
+    size_t* conc_lens = malloc(conc_n * sizeof(size_t));
+    for (size_t i = 0; i < conc_n; ++i) {
+        conc_strs[i] = conc + conc_offs[i];
+        conc_lens[i] = conc_offs[i + 1] - conc_offs[i];
+    }
+    BatchArgs args[SYMBOL_MAX_THREADS];
+    pthread_t tids[SYMBOL_MAX_THREADS];
+    for (size_t t = 0; t < SYMBOL_MAX_THREADS; ++t) {
+        args[t] = (BatchArgs){ conc_strs, conc_lens, conc_n, t * 2503, malloc(conc_n * sizeof(Symbol)) };
+        assert_int_equal(pthread_create(&tids[t], NULL, batch_worker, &args[t]), 0);
+    }
+    for (size_t t = 0; t < SYMBOL_MAX_THREADS; ++t) pthread_join(tids[t], NULL);
+    for (size_t i = 0; i < conc_n; ++i) {
+        for (size_t t = 1; t < SYMBOL_MAX_THREADS; ++t) assert_int_equal(args[t].out[i].id, args[0].out[i].id);
+        assert_int_equal(symbol_intern(conc_strs[i], conc_lens[i]).id, args[0].out[i].id);
+    }
+
+    for (size_t t = 0; t < SYMBOL_MAX_THREADS; ++t) free(args[t].out);
+    free(conc_strs);
+    free(conc_lens);
+    free(conc_offs);
+    free(conc);
+    free(again);
+    free(out);
+    free(lens);
+    free(strs);
+    free(offs);
+    free(names);
+}
+
+/// @brief 批量内部化::大表上查找已有符号与插入新符号，逐个与批量对比
+/// @param state
+static void benchmark_symbol_batch(void **state) {
+    MACRO_UNUSED(state);
+    const size_t batch = 256, lookups = 4U << 20, inserts = 262144;
+    symbol_table_init();
+    size_t* offs = NULL;
+    char* names = make_names("batch_warm_", SYMBOL_BENCH_WARM, &offs);
+    for (size_t i = 0; i < SYMBOL_BENCH_WARM; ++i) symbol_intern(names + offs[i], offs[i + 1] - offs[i]);
+    const char* strs[256];
+    size_t lens[256];
+    Symbol out[256];
+
+    // 已有符号：工作集超出线程缓存，跨步访问
+    struct timespec t0, t1, t2;
+    uint32_t sink = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (size_t i = 0, k = 0; i < lookups; ++i, k = (k + 7919) & (SYMBOL_BENCH_WARM - 1)) {
+        sink += symbol_intern(names + offs[k], offs[k + 1] - offs[k]).id;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (size_t i = 0, k = 0; i < lookups; i += batch) {
+        for (size_t j = 0; j < batch; ++j, k = (k + 7919) & (SYMBOL_BENCH_WARM - 1)) {
+            strs[j] = names + offs[k];
+            lens[j] = offs[k + 1] - offs[k];
+        }
+        symbol_intern_batch(strs, lens, batch, out);
+        sink += out[0].id;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    assert_true(sink != 0);
+    printf("[Symbol] existing (%d names): single %.1f ns/op, batch of %zu %.1f ns/op\n", SYMBOL_BENCH_WARM,
+           bench_secs(&t0, &t1) * 1e9 / (double)lookups, batch, bench_secs(&t1, &t2) * 1e9 / (double)lookups);
+    free(offs);
+    free(names);
+
+    // 新符号：两组互不相同的名字，逐块交替以逐个/批量方式插入，使两者面对同样大小的表
+    size_t* a_offs = NULL;
+    size_t* b_offs = NULL;
+    char* a = make_names("batch_new_single_", inserts, &a_offs);
+    char* b = make_names("batch_new_many_", inserts, &b_offs);
+    double single = 0, batched = 0;
+    for (size_t i = 0; i < inserts; i += batch) {
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (size_t j = i; j < i + batch; ++j) symbol_intern(a + a_offs[j], a_offs[j + 1] - a_offs[j]);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        for (size_t j = 0; j < batch; ++j) {
+            strs[j] = b + b_offs[i + j];
+            lens[j] = b_offs[i + j + 1] - b_offs[i + j];
+        }
+        symbol_intern_batch(strs, lens, batch, out);
+        clock_gettime(CLOCK_MONOTONIC, &t2);
+        single += bench_secs(&t0, &t1);
+        batched += bench_secs(&t1, &t2);
+    }
+    printf("[Symbol] new (%zu names): single %.1f ns/op, batch of %zu %.1f ns/op\n", inserts,
+           single * 1e9 / (double)inserts, batch, batched * 1e9 / (double)inserts);
+    free(a_offs);
+    free(b_offs);
+    free(a);
+    free(b);
+}
+
+// ==============================================================
+/// @brief 线程本地缓存::命中统计、槽位冲突与线程隔离
+/// @param state
+static void* cache_stats_worker(void* arg) {
+    SymbolCacheStats* stats = arg;
+    symbol_intern("alpha", 5);
+    symbol_cache_stats(stats);
+    return NULL;
+}
+
+static void test_symbol_cache(void **state) {
+    MACRO_UNUSED(state);
+    symbol_table_init();
+    symbol_cache_reset_stats();
+    SymbolCacheStats stats;
+
+    Symbol a = symbol_intern("cache_alpha", 11);
+    Symbol b = symbol_intern("cache_alpha", 11);
+    assert_int_equal(a.id, b.id);
+    symbol_cache_stats(&stats);
+    assert_int_equal(stats.misses, 1);
+    assert_int_equal(stats.hits, 1);
+
+    // 名字数远超缓存槽数：替换路径下结果仍须与全局表一致
+    size_t* offs = NULL;
+    const size_t n = SYMBOL_CACHE_SIZE * 4;
+    char* names = make_names("test_cache_", n, &offs);
+    uint32_t* ids = malloc(n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; ++i) {
+        ids[i] = symbol_intern(names + offs[i], offs[i + 1] - offs[i]).id;
+    }
+    for (size_t r = 0; r < 2; ++r) {
+        for (size_t i = 0; i < n; ++i) {
+            Symbol s = symbol_intern(names + offs[i], offs[i + 1] - offs[i]);
+            assert_int_equal(s.id, ids[i]);
+            assert_memory_equal(symbol_str(s), names + offs[i], offs[i + 1] - offs[i]);
+        }
+    }
+    symbol_cache_stats(&stats);
+    assert_int_equal(stats.hits + stats.misses, 2 + 3 * n);
+    assert_true(stats.hits > 1);
+
+    // 统计按线程隔离
+    SymbolCacheStats other;
+    pthread_t tid;
+    pthread_create(&tid, NULL, cache_stats_worker, &other);
+    pthread_join(tid, NULL);
+    assert_int_equal(other.hits + other.misses, 1);
+
+    free(ids);
+    free(offs);
+    free(names);
+}
+
+// 读取仓库中的源码文件作为真实语料（相对本文件定位）
+static char* read_repo_sources(size_t* out_len) {
+    static const char* files[] = {
+        "../src/core/lexer/lexer.c", "../src/core/lexer/token.c", "../src/core/lexer/symbol.c",
+        "../src/core/lexer/literal.c", "../src/core/lexer/ntok.c", "../src/core/lexer/scan.c",
+        "../src/core/pool/pool.c", "test_lexer.c", "test_token.c",
+    };
+    char dir[1024];
+    const char* slash = strrchr(__FILE__, '/');
+    int dir_len = slash ? (int)(slash - __FILE__) + 1 : 0;
+    size_t cap = 1 << 20, len = 0;
+    char* buf = malloc(cap);
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i) {
+        snprintf(dir, sizeof(dir), "%.*s%s", dir_len, __FILE__, files[i]);
+        FILE* f = fopen(dir, "rb");
+        if (!f) continue;
+        size_t n;
+        while ((n = fread(buf + len, 1, cap - len, f)) > 0) {
+            len += n;
+            if (len == cap) buf = realloc(buf, cap *= 2);
+        }
+        fclose(f);
+    }
+    *out_len = len;
+    return buf;
+}
+
+/// @brief 线程本地缓存::词法分析真实源码时的命中率与吞吐
+/// @param state
+static void benchmark_symbol_cache(void **state) {
+    MACRO_UNUSED(state);
+    size_t len = 0;
+    char* src = read_repo_sources(&len);
+    if (len == 0) {
+        printf("[Symbol] cache benchmark skipped: sources not found\n");
+        free(src);
+        return;
+    }
+    token_pool_init(TOKEN_POOL_BLOCK);
+    symbol_table_init();
+    symbol_cache_reset_stats();
+
+    const int rounds = 20;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; r < rounds; ++r) {
+        TokenStream ts;
+        lexer_tokenize(src, len, &ts);
+        token_stream_free(&ts);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    SymbolCacheStats stats;
+    symbol_cache_stats(&stats);
+    printf("[Symbol] cache on %zu KB of repo sources: %.2f%% hits (%llu / %llu), lex %.2f MB/s\n",
+           len >> 10, 100.0 * (double)stats.hits / (double)(stats.hits + stats.misses),
+           (unsigned long long)stats.hits, (unsigned long long)(stats.hits + stats.misses),
+           (double)len * rounds / bench_secs(&t0, &t1) / 1e6);
+
+    free(src);
+    token_pool_cleanup();
+}
+
+// ==============================================================
+/// @brief 哈希::固定种子下输出稳定（各长度分支的已知值）、预定义哈希与运行时一致
+/// @param state
+static void test_symbol_hash(void **state) {
+    MACRO_UNUSED(state);
+    static uint8_t buf[5000];
+    for (size_t i = 0; i < sizeof(buf); ++i) buf[i] = (uint8_t)(i * 131 + 7);
+
+    // 这些值可能已被持久化：任何构建（标量/AVX2）下都必须保持不变
+    static const struct { size_t len; uint64_t hash; } known[] = {
+        {0, 0xc2b31dd88c613ccfULL},     {1, 0x156ede7e088a204fULL},
+        {3, 0xe1d791c08938a2b5ULL},     {4, 0x80d7d66828b4f2acULL},
+        {7, 0xb4d2f1ee88272f5cULL},     {8, 0x5d5bcedc8115ac0aULL},
+        {15, 0xdbea9cb3381f3abdULL},    {16, 0xc1ec67e144141793ULL},
+        {17, 0x9afc6a9817ff81cfULL},    {33, 0x9eb58456d43e3878ULL},
+        {64, 0x242078614a40afefULL},    {65, 0x373678bae0e5a68cULL},
+        {96, 0x03eaf055fa0c9e96ULL},    {100, 0x75241ce681eac24fULL},
+        {1024, 0x6df460d14c59b024ULL},  {1057, 0xaeef266fed7f69ceULL},
+        {5000, 0xa1fca288715862f2ULL},
+    };
+    for (size_t i = 0; i < sizeof(known) / sizeof(known[0]); ++i) {
+        assert_true(hash64(buf, known[i].len, HASH64_SEED) == known[i].hash);
+    }
+
+    // 结果不依赖起始地址对齐；任一字节变化都改变哈希
+    static uint8_t shifted[sizeof(buf) + 1];
+    memcpy(shifted + 1, buf, sizeof(buf));
+    for (size_t len = 0; len <= 300; ++len) {
+        uint64_t h = hash64(buf, len, HASH64_SEED);
+        assert_true(hash64(shifted + 1, len, HASH64_SEED) == h);
+        assert_true(hash64(buf, len, HASH64_SEED + 1) != h);
+        for (size_t k = 0; k < len; ++k) {
+            buf[k] ^= 1;
+            assert_true(hash64(buf, len, HASH64_SEED) != h);
+            buf[k] ^= 1;
+        }
+    }
+
+    // symbol_defs.h中的预计算哈希
+    #define SYM(label, str, hash) \
+        assert_true(hash64(str, sizeof(str) - 1, HASH64_SEED) == (hash));
+    #include "lexer/symbol_defs.h"
+    SYMBOL_LIST
+    #undef SYMBOL_LIST
+    #undef SYM
+}
+
+// 旧实现（32位FNV-1a），作为基准对照
+static uint32_t bench_fnv1a(const char* str, size_t len) {
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= (uint8_t)str[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+/// @brief 哈希::各键长下hash64与FNV-1a的吞吐
+/// @param state
+static void benchmark_symbol_hash(void **state) {
+    MACRO_UNUSED(state);
+    static const size_t lens[] = { 4, 8, 16, 32, 64, 256, 4096 };
+    const size_t total = 256U << 20;            // 每个键长哈希的总字节数
+    char* buf = malloc(4096 + 64);
+    for (size_t i = 0; i < 4096 + 64; ++i) buf[i] = (char)('a' + i % 26);
+
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); ++l) {
+        const size_t len = lens[l], n = total / len;
+        struct timespec t0, t1, t2;
+        uint64_t sink = 0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (size_t i = 0; i < n; ++i) sink += bench_fnv1a(buf + (i & 63), len);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        for (size_t i = 0; i < n; ++i) sink += hash64(buf + (i & 63), len, HASH64_SEED);
+        clock_gettime(CLOCK_MONOTONIC, &t2);
+        assert_true(sink != 0);
+        printf("[Symbol] hash %4zu B keys: fnv1a %7.2f Mops/s %6.2f GB/s, hash64 %7.2f Mops/s %6.2f GB/s\n",
+               len, n / bench_secs(&t0, &t1) / 1e6, total / bench_secs(&t0, &t1) / 1e9,
+               n / bench_secs(&t1, &t2) / 1e6, total / bench_secs(&t1, &t2) / 1e9);
+    }
+    free(buf);
+}
+
+// ==============================================================
+// 临时快照文件路径
+static void snapshot_path(char* buf, size_t size) {
+    snprintf(buf, size, "/tmp/north_symtab_%ld_XXXXXX", (long)getpid());
+    int fd = mkstemp(buf);
+    if (fd != -1) close(fd);
+}
+
+// 与symbol.c中快照头部布局一致，仅用于测试中定位各段
+typedef struct SnapshotLayout {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t endian;
+    uint64_t seed;
+    uint32_t count;
+    uint32_t predefined;
+    uint64_t buckets;
+    uint64_t entries_off;
+    uint64_t ctrl_off;
+    uint64_t slots_off;
+    uint64_t strings_off;
+    uint64_t strings_size;
+    uint64_t file_size;
+} SnapshotLayout;
+
+static void snapshot_layout(const char* path, SnapshotLayout* h) {
+    FILE* f = fopen(path, "rb");
+    assert_non_null(f);
+    assert_int_equal(fread(h, sizeof(*h), 1, f), 1);
+    fclose(f);
+}
+
+static void snapshot_patch(const char* path, uint64_t offset, const void* data, size_t size) {
+    FILE* f = fopen(path, "r+b");
+    assert_non_null(f);
+    fseek(f, (long)offset, SEEK_SET);
+    assert_int_equal(fwrite(data, size, 1, f), 1);
+    fclose(f);
+}
+
+/// @brief 快照::保存、加载后ID不变，新符号叠加在基础层之上，损坏或不匹配的文件被拒绝，
+///        控制字节损坏时查找仍会结束
+/// @param state
+static void test_symbol_snapshot(void **state) {
+    MACRO_UNUSED(state);
+    char path[64], layered[64];
+    snapshot_path(path, sizeof(path));
+    snapshot_path(layered, sizeof(layered));
+
+    symbol_table_cleanup();
+    symbol_table_init();
+    size_t* offs = NULL;
+    const size_t n = 20000;
+    char* names = make_names("test_snapshot_", n, &offs);
+    uint32_t* ids = malloc(n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; ++i) ids[i] = symbol_intern(names + offs[i], offs[i + 1] - offs[i]).id;
+    SymbolTableStats cold;
+    symbol_table_stats(&cold);
+    assert_int_equal(symbol_table_save(path), 0);
+    assert_int_equal(symbol_table_load(path), -1);         // 已初始化
+
+    // 加载：旧符号ID不变，新符号从基础层之后编号
+    symbol_table_cleanup();
+    assert_int_equal(symbol_table_load(path), 0);
+    SymbolTableStats warm;
+    symbol_table_stats(&warm);
+    assert_int_equal(warm.base_symbols, cold.symbols);
+    assert_int_equal(warm.symbols, cold.symbols);
+    assert_int_equal(warm.arena_chunks, 0);
+    for (size_t i = 0; i < n; ++i) {
+        Symbol s = symbol_intern(names + offs[i], offs[i + 1] - offs[i]);
+        assert_int_equal(s.id, ids[i]);
+        assert_int_equal(s.flags, SYM_FLAG_INTERNED);
+        assert_memory_equal(symbol_str(s), names + offs[i], offs[i + 1] - offs[i]);
+    }
+    Symbol as = symbol_intern("as", 2);
+    assert_int_equal(as.id, SYM_AS);
+    assert_int_equal(as.flags, SYM_FLAG_PREDEFINED);
+    Symbol fresh = symbol_intern("snapshot_fresh", 14);
+    assert_int_equal(fresh.id, cold.symbols);
+    assert_string_equal(symbol_str(fresh), "snapshot_fresh");
+    assert_int_equal(symbol_intern("snapshot_fresh", 14).id, fresh.id);
+
+    // 基础层+新符号再次保存，两层的ID都保持
+    assert_int_equal(symbol_table_save(layered), 0);
+    symbol_table_cleanup();
+    assert_int_equal(symbol_table_load(layered), 0);
+    assert_int_equal(symbol_intern("snapshot_fresh", 14).id, fresh.id);
+    assert_int_equal(symbol_intern(names + offs[n - 1], offs[n] - offs[n - 1]).id, ids[n - 1]);
+    assert_int_equal(symbol_intern("snapshot_next", 13).id, fresh.id + 1);
+
+    // 没有空槽的索引：未命中的查找走遍各组后结束
+    SnapshotLayout h;
+    snapshot_layout(path, &h);
+    uint8_t* full = malloc(h.buckets);
+    memset(full, 0, h.buckets);
+    snapshot_patch(path, h.ctrl_off, full, h.buckets);
+    free(full);
+    symbol_table_cleanup();
+    assert_int_equal(symbol_table_load(path), 0);
+    assert_int_equal(symbol_intern("snapshot_missing", 16).id, cold.symbols);
+
+    // 字符串区间越界的条目：拒绝加载
+    uint32_t bad_str = (uint32_t)h.strings_size;
+    snapshot_patch(path, h.entries_off + SYM_COUNT * sizeof(SymbolSnapshotEntry) + offsetof(SymbolSnapshotEntry, str),
+                   &bad_str, sizeof(bad_str));
+    symbol_table_cleanup();
+    assert_int_equal(symbol_table_load(path), -1);
+
+    // 截断、改写魔数与不存在的文件
+    symbol_table_cleanup();
+    FILE* f = fopen(path, "r+b");
+    assert_non_null(f);
+    assert_int_equal(fputc('X', f), 'X');
+    fclose(f);
+    assert_int_equal(symbol_table_load(path), -1);
+    assert_int_equal(truncate(layered, 100), 0);
+    assert_int_equal(symbol_table_load(layered), -1);
+    assert_int_equal(symbol_table_load("/nonexistent/north_symtab"), -1);
+    symbol_table_init();
+    assert_int_equal(symbol_intern("as", 2).id, SYM_AS);
+    assert_int_equal(symbol_intern("snapshot_fresh", 14).id, SYM_COUNT);
+
+    unlink(path);
+    unlink(layered);
+    free(ids);
+    free(offs);
+    free(names);
+    symbol_table_cleanup();
+}
+
+/// @brief 快照::冷启动内部化与加载快照后内部化同一批标识符的耗时
+/// @param state
+static void benchmark_symbol_snapshot(void **state) {
+    MACRO_UNUSED(state);
+    char path[64];
+    snapshot_path(path, sizeof(path));
+    size_t* offs = NULL;
+    const size_t n = 200000;
+    char* names = make_names("bench_snapshot_", n, &offs);
+
+    struct timespec t0, t1, t2, t3;
+    symbol_table_cleanup();
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    symbol_table_init();
+    for (size_t i = 0; i < n; ++i) symbol_intern(names + offs[i], offs[i + 1] - offs[i]);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    assert_int_equal(symbol_table_save(path), 0);
+    symbol_table_cleanup();
+
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    assert_int_equal(symbol_table_load(path), 0);
+    clock_gettime(CLOCK_MONOTONIC, &t3);
+    struct timespec t4;
+    for (size_t i = 0; i < n; ++i) symbol_intern(names + offs[i], offs[i + 1] - offs[i]);
+    clock_gettime(CLOCK_MONOTONIC, &t4);
+    SymbolTableStats stats;
+    symbol_table_stats(&stats);
+    assert_int_equal(stats.arena_chunks, 0);
+
+    struct stat st;
+    stat(path, &st);
+    printf("[Symbol] snapshot of %zu symbols (%lld KB): cold init+intern %.2f ms, load %.3f ms, warm intern %.2f ms\n",
+           n, (long long)st.st_size >> 10, bench_secs(&t0, &t1) * 1e3,
+           bench_secs(&t2, &t3) * 1e3, bench_secs(&t3, &t4) * 1e3);
+
+    unlink(path);
+    free(offs);
+    free(names);
+    symbol_table_cleanup();
+}
+
+void entry_symbol(void** state) {
+    MACRO_UNUSED(state);
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_symbol_intern),
+        cmocka_unit_test(test_symbol_arena),
+        cmocka_unit_test(benchmark_symbol_intern),
+        cmocka_unit_test(test_symbol_concurrent),
+        cmocka_unit_test(benchmark_symbol_intern_threads),
+        cmocka_unit_test(benchmark_symbol_lookup),
+        cmocka_unit_test(test_symbol_batch),
+        cmocka_unit_test(benchmark_symbol_batch),
+        cmocka_unit_test(test_symbol_cache),
+        cmocka_unit_test(benchmark_symbol_cache),
+        cmocka_unit_test(test_symbol_hash),
+        cmocka_unit_test(benchmark_symbol_hash),
+        cmocka_unit_test(test_symbol_snapshot),
+        cmocka_unit_test(benchmark_symbol_snapshot),
+    };
+    cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -3,6 +3,7 @@
 #include <stdarg.h>
 #include <assert.h>
 #include <pthread.h>
+#include <time.h>
 
 #include <setjmp.h>
 #include <cmocka.h>
@@ -137,7 +138,9 @@ static void test_invalid_free(void **state) {
     token_pool_init(TOKEN_POOL_BLOCK);
     Token invalid_token;
     token_free(&invalid_token); // 未对齐的指针
+#if !defined(TOKEN_RECLAIM_MAGAZINE)
     assert_int_equal(&invalid_token, test_get_free_list().ptr);
+#endif
     token_pool_cleanup();
     assert_int_equal(test_get_total_allocated(), 0);
 }
@@ -192,6 +195,149 @@ static void test_order_base(void **state) {
     printf("total_allocated: %lu\n", total_allocated);
 }
 
+// ================================================================
+/// @brief 字面量侧表::Token仅保存索引，错误信息内部化
+/// @param state 
+static void test_literal_side_table(void **state) {
+    MACRO_UNUSED(state);
+    symbol_table_init();
+    token_pool_init(TOKEN_POOL_BLOCK);
+    assert_int_equal(sizeof(Token), CACHE_LINE_SIZE);
+
+    Literal lit = {
+        .kind = LIT_INTEGER,
+        .symbol = symbol_intern("42", 2),
+        .as.int_val = 42,
+    };
+    Token* t = create_literal(lit, (Span){2, 0});
+    const Literal* got = token_literal(t);
+    assert_non_null(got);
+    assert_int_equal(got->kind, LIT_INTEGER);
+    assert_int_equal(got->as.int_val, 42);
+
+    // 跨段写入，早期索引地址保持稳定
+    for (int i = 0; i < 4096; i++) {
+        create_literal(lit, (Span){0, 0});
+    }
+    assert_ptr_equal(token_literal(t), got);
+    assert_int_equal(test_get_literal_count(), 4097);
+
+    Token* e1 = create_error_token(7, "unterminated string", (Span){0, 0});
+    Token* e2 = create_error_token(7, "unterminated string", (Span){0, 0});
+    const Literal* l1 = token_literal(e1);
+    const Literal* l2 = token_literal(e2);
+    assert_int_equal(l1->kind, LIT_ERR);
+    assert_int_equal(l1->as.error.error_code, 7);
+    assert_int_equal(l1->as.error.message.id, l2->as.error.message.id);
+    assert_string_equal(symbol_str(l1->as.error.message), "unterminated string");
+
+    // 侧表编号耗尽：不返回携带无效编号的Token
+    test_set_literal_count(LIT_ID_INVALID);
+    assert_null(create_literal(lit, (Span){0, 0}));
+    assert_null(create_error_token(7, "unterminated string", (Span){0, 0}));
+
+    token_pool_cleanup();
+    assert_int_equal(test_get_literal_count(), 0);
+}
+
+// ================================================================
+/// @brief 内存修剪::释放完全空闲的块并遵守常驻上限
+/// @param state 
+static void test_pool_trim_and_limit(void **state) {
+    MACRO_UNUSED(state);
+    token_pool_init(TOKEN_POOL_BLOCK);
+    enum { N = TOKEN_POOL_BLOCK * 8 };
+    static Token* toks[N];
+    for (int i = 0; i < N; i++) {
+        toks[i] = token_alloc(Tk_Comma, (Span){0, 0});
+        assert_non_null(toks[i]);
+    }
+
+    TokenPoolStats st;
+    token_pool_stats(&st);
+    assert_int_equal(st.blocks, 8);
+    assert_int_equal(st.in_use, N);
+
+    // 保留第一个块中的一个Token，其余全部释放
+    for (int i = 1; i < N; i++) token_free(toks[i]);
+    size_t released = token_pool_trim(0);
+    assert_true(released > 0);
+    token_pool_stats(&st);
+    assert_int_equal(st.blocks, 1);
+    assert_int_equal(st.in_use, 1);
+    assert_int_equal(st.peak_resident, N);
+
+    // 保留块中的空闲Token仍可复用
+    for (int i = 1; i < TOKEN_POOL_BLOCK; i++) {
+        toks[i] = token_alloc(Tk_Comma, (Span){0, 0});
+        assert_non_null(toks[i]);
+    }
+    token_pool_stats(&st);
+    assert_int_equal(st.blocks, 1);
+
+    // 常驻上限：超过后分配失败
+    token_pool_set_limit(TOKEN_POOL_BLOCK * 2);
+    for (int i = 0; i < TOKEN_POOL_BLOCK; i++) {
+        assert_non_null(token_alloc(Tk_Comma, (Span){0, 0}));
+    }
+    assert_null(token_alloc(Tk_Comma, (Span){0, 0}));
+    token_pool_set_limit(0);
+    assert_non_null(token_alloc(Tk_Comma, (Span){0, 0}));
+
+    token_pool_cleanup();
+    assert_int_equal(test_get_total_allocated(), 0);
+}
+
+// ================================================================
+/// @brief 基准测试::空闲链表回收策略在1~32线程下的吞吐
+/// @param state 
+#define RECLAIM_BENCH_OPS   200000
+#define RECLAIM_BENCH_HOLD  16
+
+static void* reclaim_bench_thread(void* arg) {
+    MACRO_UNUSED(arg);
+    Token* held[RECLAIM_BENCH_HOLD];
+    for (int i = 0; i < RECLAIM_BENCH_OPS / RECLAIM_BENCH_HOLD; i++) {
+        for (int j = 0; j < RECLAIM_BENCH_HOLD; j++) {
+            held[j] = token_alloc(Tk_Ident, (Span){0, 0});
+        }
+        for (int j = 0; j < RECLAIM_BENCH_HOLD; j++) {
+            token_free(held[j]);
+        }
+    }
+    return NULL;
+}
+
+static void benchmark_token_reclaim(void **state) {
+    MACRO_UNUSED(state);
+#if defined(TOKEN_RECLAIM_MAGAZINE)
+    const char* scheme = "magazine";
+#else
+    const char* scheme = "tagged-pointer";
+#endif
+    const int thread_counts[] = {1, 2, 4, 8, 16, 32};
+    for (size_t k = 0; k < sizeof(thread_counts) / sizeof(thread_counts[0]); k++) {
+        int n = thread_counts[k];
+        pthread_t threads[32];
+        token_pool_init(TOKEN_POOL_BLOCK);
+
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int i = 0; i < n; i++) {
+            pthread_create(&threads[i], NULL, reclaim_bench_thread, NULL);
+        }
+        for (int i = 0; i < n; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+
+        double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+        double ops = 2.0 * n * RECLAIM_BENCH_OPS;      // alloc + free
+        printf("[Token reclaim: %s] %2d Threads: %.2f Mops/sec\n", scheme, n, ops / secs / 1e6);
+        token_pool_cleanup();
+    }
+}
+
 static int test_setup(void **state) {
     token_pool_init(0);
     *state = NULL;
@@ -209,6 +355,9 @@ void entry_token(void** state) {
         cmocka_unit_test_setup(test_invalid_free, test_setup),
         cmocka_unit_test_setup(test_cross_block_allocation, test_setup),
         cmocka_unit_test_setup(test_order_base, test_setup),
+        cmocka_unit_test_setup(test_literal_side_table, test_setup),
+        cmocka_unit_test_setup(test_pool_trim_and_limit, test_setup),
+        cmocka_unit_test(benchmark_token_reclaim),
     };
     cmocka_run_group_tests(tests, NULL, NULL);
 }